@@ -0,0 +1,132 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+// Koszt szyfrowania i odszyfrowania jednego komunikatu:
+// - "per message": obiekty Botan tworzone od nowa dla każdego komunikatu (dawna wersja Crypto),
+// - "session": kontekst sesji z Crypto (tryb Signed i Aead).
+//      CryptoBench --messages 2000 --size 1024
+#include "../common/crypto/crypto.h"
+#include "../common/crypto/keypool.h"
+#include <chrono>
+#include <charconv>
+#include <functional>
+#include <print>
+#include <string_view>
+
+using namespace bee::crypto;
+using namespace std::chrono;
+
+namespace {
+    constexpr auto SIGN_ALGO = "PKCS1v15(SHA-256)";
+
+    double measure(size_t const n, std::function<void()> const& fn) {
+        auto const start = steady_clock::now();
+        for (size_t i = 0; i < n; ++i)
+            fn();
+        return duration_cast<duration<double, std::micro>>(steady_clock::now() - start).count() / n;
+    }
+
+    /// Szyfrowanie i podpis z tworzeniem wszystkich obiektów dla komunikatu.
+    SecVector<u8> legacyEncrypt(Botan::Private_Key const& key, SecVector<u8> const& aes, Span<const u8> const data) {
+        auto const encryptor = Botan::AEAD_Mode::create_or_throw("AES-256/GCM", Botan::Cipher_Dir::Encryption);
+        auto const nonce = rng.random_vec<SecVector<u8>>(12);
+        SecVector<u8> buffer{nonce.begin(), nonce.end()};
+        buffer.insert(buffer.end(), data.begin(), data.end());
+        encryptor->set_key(aes);
+        encryptor->start(nonce);
+        encryptor->finish(buffer, nonce.size());
+
+        Botan::PK_Signer signer{key, rng, SIGN_ALGO};
+        signer.update(buffer);
+        auto signed_message = signer.signature(rng);
+        signed_message.insert(signed_message.end(), buffer.begin(), buffer.end());
+        return {signed_message.begin(), signed_message.end()};
+    }
+
+    /// Weryfikacja i odszyfrowanie z tworzeniem wszystkich obiektów dla komunikatu.
+    bool legacyDecrypt(Botan::Public_Key const& key, SecVector<u8> const& aes, Span<const u8> const data) {
+        Botan::PK_Verifier verifier{key, SIGN_ALGO};
+        auto const message = data.subspan(256);
+        verifier.update(message);
+        if (not verifier.check_signature(data.first(256)))
+            return false;
+
+        auto const decryptor = Botan::AEAD_Mode::create_or_throw("AES-256/GCM", Botan::Cipher_Dir::Decryption);
+        SecVector<u8> buffer{message.begin() + 12, message.end()};
+        decryptor->set_key(aes);
+        decryptor->start(message.first(12));
+        decryptor->finish(buffer);
+        return true;
+    }
+}
+
+int main(int const argc, char* argv[]) {
+    size_t messages{2000};
+    size_t size{1024};
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string_view const key{argv[i]};
+        std::string_view const value{argv[i + 1]};
+        auto& out = (key == "--size") ? size : messages;
+        std::from_chars(value.data(), value.data() + value.size(), out);
+    }
+
+    std::shared_ptr<Botan::Private_Key const> const clientKey = KeyPool::generate();
+    std::shared_ptr<Botan::Private_Key const> const serverKey = KeyPool::generate();
+    Crypto client{clientKey};
+    Crypto server{serverKey};
+    server.side(Side::Server);
+    client.setBuddyRSAPublicKey(server.RSAPublicKeyBER());
+    server.setBuddyRSAPublicKey(client.RSAPublicKeyBER());
+    auto aes = client.generateAESKey().value();
+    server.setAESKey(SecVector<u8>{aes});
+
+    auto const plain = Crypto::RandomBytes(size);
+    auto const clientPublic = clientKey->public_key();
+
+    auto const legacy = measure(messages, [&] {
+        auto message = legacyEncrypt(*clientKey, aes, plain);
+        legacyDecrypt(*clientPublic, aes, message);
+    });
+
+    auto const session = [&](Auth const mode) {
+        client.auth(mode);
+        server.auth(mode);
+        return measure(messages, [&] {
+            auto message = client.encrypt(plain).value();
+            (void)server.decrypt(message);
+        });
+    };
+    auto const sessionSigned = session(Auth::Signed);
+    auto const sessionAead = session(Auth::Aead);
+
+    std::println("message size: {} B, messages: {}", size, messages);
+    std::println("  per message (signed): {:10.2f} us/msg", legacy);
+    std::println("  session     (signed): {:10.2f} us/msg", sessionSigned);
+    std::println("  session     (aead)  : {:10.2f} us/msg", sessionAead);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,177 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+// Pomiar przepustowości serwera dla różnych transportów.
+// Serwer uruchamiamy z --transport blocking|epoll|uring, a następnie:
+//      TransportBench --clients 32 --requests 10000 [--format json|beve] [--payload 4096] [--depth 64 [--dispatch concurrent]] [--compression none] [--pool 8]
+// i porównujemy wyniki. Z --pool N wątki klientów nie mają własnych połączeń,
+// każde żądanie wypożycza jedno z N połączeń ClientPool (krótkie serie żądań).
+// Żądania są typu Unknown, więc serwer
+// odpowiada od razu - mierzymy wyłącznie transport i szyfrowanie.
+#include "../request.h"
+#include "../pipeline.h"
+#include "../clientpool.h"
+#include "../common/socket/connector.h"
+#include "../common/socket/logger.h"
+#include "../common/crypto/keypool.h"
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <charconv>
+#include <memory>
+#include <print>
+#include <string_view>
+#include <thread>
+
+using namespace bee;
+using namespace std::chrono;
+
+namespace {
+    struct Options {
+        String host{"127.0.0.1"};
+        int port{123456};
+        size_t clients{16};
+        size_t requests{1000};
+        Format format{Format::Beve};
+        size_t payload{};       // rozmiar Request::content w bajtach
+        size_t depth{1};        // ile żądań jednego klienta czeka naraz na odpowiedź (Pipeline)
+        Dispatch dispatch{Dispatch::Ordered};
+        Compression compression{SupportedCompression};
+        size_t pool{};          // liczba połączeń wspólnej puli (0 - każdy klient ma własne)
+    };
+
+    Options options(int const argc, char* argv[]) noexcept {
+        Options opt{};
+        for (int i = 1; i + 1 < argc; i += 2) {
+            std::string_view const key{argv[i]};
+            std::string_view const value{argv[i + 1]};
+            auto const number = [value](auto& out) {
+                std::from_chars(value.data(), value.data() + value.size(), out);
+            };
+            if (key == "--host") opt.host = value;
+            else if (key == "--port") number(opt.port);
+            else if (key == "--clients") number(opt.clients);
+            else if (key == "--requests") number(opt.requests);
+            else if (key == "--format") opt.format = (value == "json") ? Format::Json : Format::Beve;
+            else if (key == "--payload") number(opt.payload);
+            else if (key == "--depth") number(opt.depth);
+            else if (key == "--dispatch") opt.dispatch = (value == "concurrent") ? Dispatch::Concurrent : Dispatch::Ordered;
+            else if (key == "--compression") opt.compression = (value == "none") ? Compression::None : SupportedCompression;
+            else if (key == "--pool") number(opt.pool);
+        }
+        return opt;
+    }
+}
+
+int main(int const argc, char* argv[]) {
+    auto const opt = options(argc, argv);
+    SessionOptions const session{.auth = crypto::Auth::Aead, .format = opt.format, .dispatch = opt.dispatch, .compression = opt.compression};
+    // Klucze klientów generowane są w tle, równolegle z łączeniem.
+    crypto::KeyPool::self().start(opt.pool ? opt.pool : opt.clients);
+    std::atomic<size_t> done{};
+    std::atomic<size_t> failed{};
+
+    // Połączenia puli otwierane są w tle, czas ich otwarcia wlicza się do pomiaru.
+    std::unique_ptr<ClientPool> pool{};
+    if (opt.pool)
+        pool = std::make_unique<ClientPool>(opt.host, opt.port, opt.pool, session);
+
+    auto const start = steady_clock::now();
+    {
+        Vector<std::jthread> threads{};
+        for (size_t c = 0; c < opt.clients; ++c) {
+            threads.emplace_back([&opt, &session, &pool, &done, &failed, c] {
+                auto const request = [&opt, c](size_t const i) {
+                    return Request{.id = c * opt.requests + i + 1, .content = Vector<u8>(opt.payload, 0xa5)};
+                };
+                if (pool) {
+                    for (size_t i = 0; i < opt.requests; ++i) {
+                        auto lease = pool->acquire();
+                        if (not lease) {
+                            print_error(lease.error());
+                            ++failed;
+                            return;
+                        }
+                        if (not request(i).write(*lease.value())) {
+                            lease->broken();
+                            ++failed;
+                            return;
+                        }
+                        ++done;
+                    }
+                    return;
+                }
+
+                Client client{};
+                client.propose(session);
+                if (auto const err = client.connect(opt.host, opt.port)) {
+                    print_error(err.value());
+                    ++failed;
+                    return;
+                }
+                if (not client.init()) {
+                    ++failed;
+                    return;
+                }
+                if (opt.depth > 1) {
+                    // Do depth żądań w drodze, odpowiedzi odbiera wątek Pipeline.
+                    Pipeline pipeline{client};
+                    std::deque<std::future<Pipeline::Answer>> window{};
+                    for (size_t i = 0; i < opt.requests or not window.empty(); ) {
+                        if (i < opt.requests and window.size() < opt.depth) {
+                            window.push_back(pipeline.send(request(i++)));
+                            continue;
+                        }
+                        if (not window.front().get()) {
+                            ++failed;
+                            return;
+                        }
+                        window.pop_front();
+                        ++done;
+                    }
+                    return;
+                }
+                for (size_t i = 0; i < opt.requests; ++i) {
+                    if (not request(i).write(client)) {
+                        ++failed;
+                        return;
+                    }
+                    ++done;
+                }
+            });
+        }
+    }
+    auto const elapsed = duration_cast<duration<double>>(steady_clock::now() - start).count();
+    // Wszystkie połączenia wróciły do puli - można ją zamknąć.
+    pool.reset();
+
+    std::println("clients: {}, requests: {}, failed clients: {}", opt.clients, done.load(), failed.load());
+    std::println("time: {:.3f} s, {:.0f} req/s, {:.1f} us/req per client",
+        elapsed, done / elapsed, elapsed * 1e6 * opt.clients / std::max<size_t>(done, 1));
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -115,10 +115,12 @@ int main() {
 
     //===============================================================
     if (not openDatabase(client, "test.sqlite")) {
-        if (not createDatabase(client, "test.sqlite")) {
-            if (not createTable(client, "person"))
+        if (not createDatabase(client, "test.sqlite"))
+            return EXIT_FAILURE;
+        // Table/Create wykonuje przesłane polecenia SQL (tabela, indeks, wyzwalacze).
+        for (auto const& command : Person::CreationCmd)
+            if (not createTable(client, command))
                 return EXIT_FAILURE;
-        }
     }
 
 
@@ -0,0 +1,161 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "clientpool.h"
+#include "common/socket/logger.h"
+#include <algorithm>
+#include <utility>
+#include <poll.h>
+
+namespace bee {
+
+    /****************************************************************
+     *                                                              *
+     *                          L E A S E                           *
+     *                                                              *
+     ****************************************************************/
+
+    Lease::Lease(ClientPool* const pool, std::unique_ptr<Client> client) noexcept
+        : pool_{pool}, client_{std::move(client)} {}
+
+    Lease::~Lease() {
+        release();
+    }
+
+    Lease::Lease(Lease&& other) noexcept
+        : pool_{std::exchange(other.pool_, nullptr)}, client_{std::move(other.client_)}, broken_{other.broken_} {}
+
+    Lease& Lease::operator=(Lease&& other) noexcept {
+        if (this != &other) {
+            release();
+            pool_ = std::exchange(other.pool_, nullptr);
+            client_ = std::move(other.client_);
+            broken_ = other.broken_;
+        }
+        return *this;
+    }
+
+    void Lease::release() noexcept {
+        if (pool_ and client_)
+            pool_->release(std::move(client_), broken_);
+        pool_ = nullptr;
+    }
+
+    /****************************************************************
+     *                                                              *
+     *                    C L I E N T   P O O L                     *
+     *                                                              *
+     ****************************************************************/
+
+    ClientPool::ClientPool(String address, int const port, size_t const size, SessionOptions const& options)
+        : address_{std::move(address)}, port_{port}, size_{std::max<size_t>(size, 1)}, options_{options},
+          worker_{[this](std::stop_token const& token) { loop(token); }} {}
+
+    Result<Lease,std::errc> ClientPool::acquire(std::chrono::milliseconds const timeout) {
+        std::unique_lock lock{mutex_};
+        // Gdy nie ma żadnego połączenia, a ostatnia próba się nie udała, nie ma na co czekać.
+        if (not cv_.wait_for(lock, timeout, [this] { return not idle_.empty() or (error_ and open_ == 0); }))
+            return Failure(error_.value_or(std::errc::timed_out));
+        if (idle_.empty())
+            return Failure(error_.value());
+        auto client = std::move(idle_.front());
+        idle_.pop_front();
+        return Lease{this, std::move(client)};
+    }
+
+    size_t ClientPool::idle() noexcept {
+        std::lock_guard lock{mutex_};
+        return idle_.size();
+    }
+
+    void ClientPool::release(std::unique_ptr<Client> client, bool const broken) noexcept {
+        std::lock_guard lock{mutex_};
+        if (broken) {
+            // Połączenie zamykane jest tutaj, nowe otworzy wątek w tle.
+            --open_;
+            cv_.notify_all();
+            return;
+        }
+        // Ostatnio używane połączenie idzie na początek - pozostałe dłużej odpoczywają.
+        idle_.push_front(std::move(client));
+        cv_.notify_all();
+    }
+
+    void ClientPool::loop(std::stop_token const& token) {
+        std::unique_lock lock{mutex_};
+        while (not token.stop_requested()) {
+            auto failed = false;
+            while (open_ < size_ and not token.stop_requested()) {
+                // Połączenie i uzgadnianie kluczy bez blokady - wypożyczanie nie czeka.
+                ++open_;
+                lock.unlock();
+                auto client = connect();
+                lock.lock();
+                if (not client) {
+                    --open_;
+                    error_ = client.error();
+                    failed = true;
+                    cv_.notify_all();
+                    break;
+                }
+                error_.reset();
+                idle_.push_back(std::move(client.value()));
+                cv_.notify_all();
+            }
+
+            auto const closed = std::erase_if(idle_, [](auto const& client) { return not alive(*client); });
+            open_ -= closed;
+            if (closed)
+                continue;
+
+            cv_.wait_for(lock, token, failed ? RetryInterval : CheckInterval, [this, failed] {
+                return not failed and open_ < size_;
+            });
+        }
+    }
+
+    Result<std::unique_ptr<Client>,std::errc> ClientPool::connect() const noexcept {
+        auto client = std::make_unique<Client>();
+        if (auto const err = client->connect(address_, port_)) {
+            print_error(err.value());
+            return Failure(err.value());
+        }
+        client->propose(options_);
+        if (not client->init())
+            return Failure(std::errc::protocol_error);
+        return client;
+    }
+
+    bool ClientPool::alive(Client const& client) noexcept {
+        // Bezczynne połączenie nie powinno mieć nic do odczytu - gotowość
+        // do odczytu oznacza zamknięcie przez serwer (lub błąd).
+        pollfd pfd{.fd = client.fd(), .events = POLLIN, .revents = 0};
+        auto const n = ::poll(&pfd, 1, 0);
+        return n == 0;
+    }
+}
@@ -0,0 +1,121 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "common/socket/connector.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace bee {
+    class ClientPool;
+
+    /*------- Lease:
+    Połączenie wypożyczone z ClientPool, wraca do puli w destruktorze.
+    Połączenie, na którym wystąpił błąd, należy oznaczyć (broken) -
+    pula je zamknie i otworzy w tle nowe.
+    -------------------------------------------------------------------*/
+    class Lease final {
+        ClientPool* pool_{};
+        std::unique_ptr<Client> client_{};
+        bool broken_{};
+    public:
+        Lease(ClientPool* pool, std::unique_ptr<Client> client) noexcept;
+        ~Lease();
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        Lease(Lease const&) = delete;
+        Lease& operator=(Lease const&) = delete;
+
+        [[nodiscard]] Client const& operator*() const noexcept { return *client_; }
+        [[nodiscard]] Client const* operator->() const noexcept { return client_.get(); }
+
+        /// Połączenie nie nadaje się do dalszego użycia.
+        void broken() noexcept { broken_ = true; }
+    private:
+        void release() noexcept;
+    };
+
+    /*------- ClientPool:
+    Pula połączeń z serwerem, gotowych do użycia (po init - uzgodnieniu
+    kluczy), żeby krótkie serie żądań nie płaciły za nawiązanie połączenia.
+    Wątek w tle utrzymuje wskazaną liczbę połączeń, otwiera nowe w miejsce
+    zepsutych i co jakiś czas sprawdza, czy serwer nie zamknął bezczynnych.
+    Wszystkie wypożyczone połączenia muszą wrócić przed zniszczeniem puli.
+    -------------------------------------------------------------------*/
+    class ClientPool final {
+    public:
+        /// Co ile sprawdzane są bezczynne połączenia.
+        static constexpr std::chrono::seconds CheckInterval{15};
+        /// Odstęp między próbami, gdy połączenie nie może zostać nawiązane.
+        static constexpr std::chrono::seconds RetryInterval{1};
+
+        /// \param address Adres serwera.
+        /// \param port Port serwera.
+        /// \param size Liczba utrzymywanych połączeń.
+        /// \param options Ustawienia proponowane serwerowi.
+        ClientPool(String address, int port, size_t size, SessionOptions const& options = {.auth = crypto::Auth::Aead, .format = Format::Beve});
+        ~ClientPool() = default;
+        ClientPool(ClientPool const&) = delete;
+        ClientPool& operator=(ClientPool const&) = delete;
+
+        /// Wypożyczenie połączenia (czeka, jeśli wszystkie są zajęte).
+        /// \param timeout Najdłuższy czas oczekiwania.
+        /// \return Połączenie, błąd ostatniej nieudanej próby połączenia
+        /// (od razu, jeśli żadne połączenie nie jest otwarte, lub po czasie)
+        /// albo std::errc::timed_out.
+        [[nodiscard]] Result<Lease,std::errc> acquire(std::chrono::milliseconds timeout = std::chrono::seconds{10});
+
+        /// Liczba połączeń gotowych do wypożyczenia.
+        [[nodiscard]] size_t idle() noexcept;
+
+    private:
+        String const address_;
+        int const port_;
+        size_t const size_;
+        SessionOptions const options_;
+
+        std::mutex mutex_{};
+        std::condition_variable_any cv_{};
+        std::deque<std::unique_ptr<Client>> idle_{};
+        size_t open_{};     // połączenia bezczynne i wypożyczone
+        Option<std::errc> error_{};  // błąd ostatniej próby połączenia (nic - udała się)
+        // Wątek w tle musi być ostatni - kończy się jako pierwszy.
+        std::jthread worker_;
+
+        void loop(std::stop_token const& token);
+        void release(std::unique_ptr<Client> client, bool broken) noexcept;
+        [[nodiscard]] Result<std::unique_ptr<Client>,std::errc> connect() const noexcept;
+        /// Czy serwer nie zamknął połączenia (bez wysyłania czegokolwiek).
+        [[nodiscard]] static bool alive(Client const& client) noexcept;
+        friend class Lease;
+    };
+}
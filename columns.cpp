@@ -0,0 +1,365 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "columns.h"
+#include <cstring>
+#include <format>
+
+namespace bee {
+
+    namespace {
+        template<typename T>
+        T load(Span<const u8> const bytes, size_t const index) noexcept {
+            T value{};
+            std::memcpy(&value, bytes.data() + index * sizeof(T), sizeof(T));
+            return value;
+        }
+
+        template<typename T>
+        void store(Vector<u8>& out, T const value) {
+            auto const ptr = reinterpret_cast<u8 const*>(&value);
+            out.insert(out.end(), ptr, ptr + sizeof(T));
+        }
+
+        template<typename T>
+        void store(Vector<u8>& out, std::pmr::vector<T> const& values) {
+            auto const ptr = reinterpret_cast<u8 const*>(values.data());
+            out.insert(out.end(), ptr, ptr + values.size() * sizeof(T));
+        }
+
+        /// Kolejne fragmenty bajtów z kontrolą rozmiaru.
+        class Reader {
+            Span<const u8> data_;
+        public:
+            explicit Reader(Span<const u8> const data) noexcept : data_{data} {}
+
+            Option<Span<const u8>> take(size_t const n) noexcept {
+                if (n > data_.size())
+                    return {};
+                auto const part = data_.first(n);
+                data_ = data_.subspan(n);
+                return part;
+            }
+            template<typename T>
+            Option<T> get() noexcept {
+                if (auto const part = take(sizeof(T)))
+                    return load<T>(*part, 0);
+                return {};
+            }
+        };
+    }
+
+    /********************************************************************
+     *                                                                  *
+     *                         C O L U M N S                            *
+     *                                                                  *
+     ********************************************************************/
+
+    Option<Columns> Columns::parse(Span<const u8> const data) noexcept {
+        Reader reader{data};
+        auto const ncolumns = reader.get<u32>();
+        auto const nrows = reader.get<u32>();
+        if (not ncolumns or not nrows)
+            return {};
+
+        Columns result{};
+        result.rows_ = *nrows;
+        result.columns_.reserve(*ncolumns);
+        for (u32 c = 0; c < *ncolumns; ++c) {
+            Column column{};
+            auto const length = reader.get<u32>();
+            if (not length)
+                return {};
+            auto const name = reader.take(*length);
+            auto const type = reader.get<u8>();
+            auto const nulls = reader.take((result.rows_ + 7) / 8);
+            if (not name or not type or not nulls or *type > static_cast<u8>(Type::Blob))
+                return {};
+            column.name = StringView{reinterpret_cast<char const*>(name->data()), name->size()};
+            column.type = static_cast<Type>(*type);
+            column.nulls = *nulls;
+
+            Option<Span<const u8>> values{Span<const u8>{}};
+            Option<Span<const u8>> offsets{Span<const u8>{}};
+            Option<Span<const u8>> bytes{Span<const u8>{}};
+            switch (column.type) {
+                case Type::Integer:
+                case Type::Real:
+                    values = reader.take(result.rows_ * sizeof(u64));
+                    break;
+                case Type::Text:
+                    if (auto const nwords = reader.get<u32>()) {
+                        offsets = reader.take((*nwords + size_t{1}) * sizeof(u32));
+                        if (offsets)
+                            bytes = reader.take(load<u32>(*offsets, *nwords));
+                        values = reader.take(result.rows_ * sizeof(u32));
+                    }
+                    else
+                        values = {};
+                    break;
+                case Type::Blob:
+                    offsets = reader.take((result.rows_ + size_t{1}) * sizeof(u32));
+                    if (offsets)
+                        bytes = reader.take(load<u32>(*offsets, result.rows_));
+                    break;
+                case Type::Null:
+                    break;
+            }
+            if (not values or not offsets or not bytes)
+                return {};
+            column.values = *values;
+            column.offsets = *offsets;
+            column.bytes = *bytes;
+            result.columns_.push_back(column);
+        }
+        return result;
+    }
+
+    bool Columns::null(size_t const c, size_t const row) const noexcept {
+        return columns_[c].nulls[row / 8] & (1u << (row % 8));
+    }
+
+    i64 Columns::integer(size_t const c, size_t const row) const noexcept {
+        auto const& column = columns_[c];
+        return column.type == Type::Integer ? load<i64>(column.values, row) : 0;
+    }
+
+    double Columns::real(size_t const c, size_t const row) const noexcept {
+        auto const& column = columns_[c];
+        return column.type == Type::Real ? load<double>(column.values, row) : 0.0;
+    }
+
+    StringView Columns::text(size_t const c, size_t const row) const noexcept {
+        auto const& column = columns_[c];
+        if (column.type != Type::Text)
+            return {};
+        auto const id = load<u32>(column.values, row);
+        if (id + size_t{1} >= column.offsets.size() / sizeof(u32))
+            return {};
+        auto const begin = load<u32>(column.offsets, id);
+        auto const end = load<u32>(column.offsets, id + 1);
+        if (begin > end or end > column.bytes.size())
+            return {};
+        return StringView{reinterpret_cast<char const*>(column.bytes.data()) + begin, end - begin};
+    }
+
+    Span<const u8> Columns::blob(size_t const c, size_t const row) const noexcept {
+        auto const& column = columns_[c];
+        if (column.type != Type::Blob)
+            return {};
+        auto const begin = load<u32>(column.offsets, row);
+        auto const end = load<u32>(column.offsets, row + 1);
+        if (begin > end or end > column.bytes.size())
+            return {};
+        return column.bytes.subspan(begin, end - begin);
+    }
+
+    /********************************************************************
+     *                                                                  *
+     *                  C O L U M N S   B U I L D E R                   *
+     *                                                                  *
+     ********************************************************************/
+
+    ColumnsBuilder::ColumnsBuilder(Span<String const> const names, std::pmr::memory_resource* const resource)
+        : columns_{resource}
+    {
+        columns_.reserve(names.size());
+        for (auto const& name : names)
+            columns_.emplace_back(name, resource);
+    }
+
+    void ColumnsBuilder::row() {
+        ++rows_;
+        column_ = 0;
+        for (auto& column : columns_)
+            column.nulls.resize((rows_ + 7) / 8);
+    }
+
+    void ColumnsBuilder::add(std::nullptr_t) {
+        auto& column = columns_[column_++];
+        auto const row = rows_ - 1;
+        column.nulls[row / 8] |= static_cast<u8>(1u << (row % 8));
+        switch (column.type) {
+            case Type::Integer: column.integers.push_back(0); break;
+            case Type::Real: column.reals.push_back(0.0); break;
+            case Type::Text: word(column, {}); break;
+            case Type::Blob: column.offsets.push_back(static_cast<u32>(column.bytes.size())); break;
+            case Type::Null: break;
+        }
+    }
+
+    void ColumnsBuilder::add(i64 const value) {
+        auto& column = next(Type::Integer);
+        switch (column.type) {
+            case Type::Integer: column.integers.push_back(value); break;
+            case Type::Real: column.reals.push_back(static_cast<double>(value)); break;
+            default: word(column, std::to_string(value));
+        }
+        bytes_ += sizeof(value);
+    }
+
+    void ColumnsBuilder::add(double const value) {
+        auto& column = next(Type::Real);
+        if (column.type == Type::Real)
+            column.reals.push_back(value);
+        else
+            word(column, std::format("{}", value));
+        bytes_ += sizeof(value);
+    }
+
+    void ColumnsBuilder::add(StringView const value) {
+        word(next(Type::Text), value);
+    }
+
+    void ColumnsBuilder::add(Span<const u8> const value) {
+        auto& column = next(Type::Blob);
+        if (column.type == Type::Blob) {
+            column.bytes.insert(column.bytes.end(), value.begin(), value.end());
+            column.offsets.push_back(static_cast<u32>(column.bytes.size()));
+            bytes_ += value.size();
+        }
+        else
+            word(column, StringView{reinterpret_cast<char const*>(value.data()), value.size()});
+    }
+
+    void ColumnsBuilder::encode(Vector<u8>& out) {
+        out.clear();
+        out.reserve(bytes_ + columns_.size() * 64);
+        store(out, static_cast<u32>(columns_.size()));
+        store(out, static_cast<u32>(rows_));
+        for (auto& column : columns_) {
+            store(out, static_cast<u32>(column.name.size()));
+            out.insert(out.end(), column.name.begin(), column.name.end());
+            store(out, static_cast<u8>(column.type));
+            column.nulls.resize((rows_ + 7) / 8);
+            out.insert(out.end(), column.nulls.begin(), column.nulls.end());
+
+            switch (column.type) {
+                case Type::Integer: store(out, column.integers); break;
+                case Type::Real: store(out, column.reals); break;
+                case Type::Text: {
+                    store(out, static_cast<u32>(column.words.size()));
+                    u32 offset{};
+                    store(out, offset);
+                    for (auto const word : column.words)
+                        store(out, offset += static_cast<u32>(word.size()));
+                    for (auto const word : column.words)
+                        out.insert(out.end(), word.begin(), word.end());
+                    store(out, column.ids);
+                    break;
+                }
+                case Type::Blob:
+                    store(out, column.offsets);
+                    out.insert(out.end(), column.bytes.begin(), column.bytes.end());
+                    break;
+                case Type::Null:
+                    break;
+            }
+
+            // Kolumna gotowa na następną porcję (pamięć zostaje).
+            column.type = Type::Null;
+            column.nulls.clear();
+            column.integers.clear();
+            column.reals.clear();
+            column.words.clear();
+            column.dictionary.clear();
+            column.ids.clear();
+            column.bytes.clear();
+            column.offsets.assign(1, 0);
+        }
+        rows_ = column_ = bytes_ = 0;
+    }
+
+    ColumnsBuilder::Column& ColumnsBuilder::next(Type const type) {
+        auto& column = columns_[column_++];
+        if (column.type == type or (column.type == Type::Real and type == Type::Integer))
+            return column;
+        if (column.type == Type::Null)
+            promote(column, type);
+        else if (column.type == Type::Integer and type == Type::Real)
+            promote(column, Type::Real);
+        else if (column.type != Type::Text)
+            promote(column, Type::Text);
+        return column;
+    }
+
+    void ColumnsBuilder::promote(Column& column, Type const type) {
+        // Wartości poprzednich wierszy (bieżący jeszcze nie ma wartości w tej kolumnie).
+        auto const count = rows_ - 1;
+        auto const from = column.type;
+        column.type = type;
+
+        if (from == Type::Null) {
+            switch (type) {
+                case Type::Integer: column.integers.assign(count, 0); break;
+                case Type::Real: column.reals.assign(count, 0.0); break;
+                case Type::Text: for (size_t i = 0; i < count; ++i) word(column, {}); break;
+                case Type::Blob: column.offsets.assign(count + 1, 0); break;
+                case Type::Null: break;
+            }
+            return;
+        }
+        if (type == Type::Real) {
+            column.reals.assign(column.integers.begin(), column.integers.end());
+            column.integers.clear();
+            return;
+        }
+
+        // Text - dotychczasowe wartości zamieniamy na tekst (NULL - pusty tekst).
+        auto const integers = std::move(column.integers);
+        auto const reals = std::move(column.reals);
+        auto const bytes = std::move(column.bytes);
+        auto const offsets = std::move(column.offsets);
+        column.integers.clear();
+        column.reals.clear();
+        column.bytes.clear();
+        column.offsets.assign(1, 0);
+        for (size_t i = 0; i < count; ++i) {
+            if (column.nulls[i / 8] & (1u << (i % 8)))
+                word(column, {});
+            else if (from == Type::Integer)
+                word(column, std::to_string(integers[i]));
+            else if (from == Type::Real)
+                word(column, std::format("{}", reals[i]));
+            else
+                word(column, StringView{reinterpret_cast<char const*>(bytes.data()) + offsets[i], offsets[i + 1] - offsets[i]});
+        }
+    }
+
+    void ColumnsBuilder::word(Column& column, StringView const text) {
+        auto it = column.dictionary.find(text);
+        if (it == column.dictionary.end()) {
+            it = column.dictionary.emplace(text, static_cast<u32>(column.words.size())).first;
+            // Klucz w węźle mapy nie zmienia położenia - słowo wskazuje na niego.
+            column.words.push_back(it->first);
+            bytes_ += text.size();
+        }
+        column.ids.push_back(it->second);
+        bytes_ += sizeof(u32);
+    }
+}
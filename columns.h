@@ -0,0 +1,147 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "shared4cx/types.h"
+#include <functional>
+#include <memory_resource>
+#include <unordered_map>
+
+namespace bee {
+
+    /*------- Columns:
+    Wynik zapytania w układzie kolumnowym, przesyłany w Response::data.
+    Każda kolumna ma jeden typ, mapę bitową wartości NULL i wartości
+    ułożone jedna za drugą; tekst kodowany jest słownikiem (każdy
+    różny tekst zapisany raz, wiersze mają jego numer).
+
+        [u32 liczba kolumn][u32 liczba wierszy]
+        kolumna: [u32 długość nazwy][nazwa][u8 typ][NULL: (wiersze + 7) / 8 bajtów][wartości]
+        wartości: Integer - i64 × wiersze, Real - double × wiersze,
+                  Text - [u32 słowo][u32 offset × (słowa + 1)][bajty][u32 numer słowa × wiersze],
+                  Blob - [u32 offset × (wiersze + 1)][bajty], Null - brak.
+
+    Columns tylko wskazuje na bajty (nic nie kopiuje) - wartości są
+    odczytywane dopiero przy dostępie do nich.
+    -------------------------------------------------------------------*/
+    class Columns final {
+    public:
+        enum class Type : u8 { Null, Integer, Real, Text, Blob };
+
+        /// Sprawdzenie układu danych i zapamiętanie położenia kolumn.
+        /// \param data Bajty wyniku - muszą istnieć tak długo jak obiekt.
+        static Option<Columns> parse(Span<const u8> data) noexcept;
+
+        [[nodiscard]] size_t size() const noexcept { return columns_.size(); }
+        [[nodiscard]] size_t rows() const noexcept { return rows_; }
+        [[nodiscard]] StringView name(size_t const c) const noexcept { return columns_[c].name; }
+        [[nodiscard]] Type type(size_t const c) const noexcept { return columns_[c].type; }
+
+        [[nodiscard]] bool null(size_t c, size_t row) const noexcept;
+        /// Wartości wskazanej kolumny i wiersza. Dla typu innego niż typ kolumny
+        /// lub wartości NULL zwracają 0 albo pusty tekst.
+        [[nodiscard]] i64 integer(size_t c, size_t row) const noexcept;
+        [[nodiscard]] double real(size_t c, size_t row) const noexcept;
+        [[nodiscard]] StringView text(size_t c, size_t row) const noexcept;
+        [[nodiscard]] Span<const u8> blob(size_t c, size_t row) const noexcept;
+
+    private:
+        struct Column {
+            StringView name{};
+            Type type{Type::Null};
+            Span<const u8> nulls{};
+            Span<const u8> values{};    // i64/double albo numery słów (Text)
+            Span<const u8> offsets{};   // Text, Blob
+            Span<const u8> bytes{};     // Text, Blob
+        };
+        Vector<Column> columns_{};
+        size_t rows_{};
+    };
+
+    /*------- ColumnsBuilder:
+    Składanie wyniku w układzie Columns, wiersz po wierszu.
+    Typ kolumny wynika z jej wartości (SQLite nie wymusza typów):
+    Integer i Real dają Real, każda inna mieszanka - Text.
+    Cała pamięć porcji (wartości, słowniki) pochodzi ze wskazanego
+    zasobu - np. z areny żądania (Arena), zwalnianej po wysłaniu porcji.
+    -------------------------------------------------------------------*/
+    class ColumnsBuilder final {
+    public:
+        /// \param names Nazwy kolumn.
+        /// \param resource Pamięć porcji - musi istnieć tak długo jak obiekt.
+        explicit ColumnsBuilder(Span<String const> names, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+        /// Nowy wiersz - kolejne wywołania add wypełniają jego kolumny po kolei.
+        void row();
+        void add(std::nullptr_t);
+        void add(i64 value);
+        void add(double value);
+        void add(StringView value);
+        void add(Span<const u8> value);
+
+        [[nodiscard]] size_t rows() const noexcept { return rows_; }
+        /// Przybliżony rozmiar danych.
+        [[nodiscard]] size_t bytes() const noexcept { return bytes_; }
+        /// Zakodowanie wyniku (obiekt można potem użyć ponownie, dla kolejnej porcji).
+        void encode(Vector<u8>& out);
+
+    private:
+        using Type = Columns::Type;
+        // Wyszukiwanie w słowniku po StringView, bez tworzenia String.
+        struct Hash {
+            using is_transparent = void;
+            size_t operator()(StringView const text) const noexcept { return std::hash<StringView>{}(text); }
+        };
+        struct Column {
+            Column(StringView name, std::pmr::memory_resource* resource)
+                : name{name, resource}, nulls{resource}, integers{resource}, reals{resource},
+                  dictionary{resource}, words{resource}, ids{resource}, bytes{resource}, offsets(1, 0, resource) {}
+
+            std::pmr::string name;
+            Type type{Type::Null};
+            std::pmr::vector<u8> nulls;
+            std::pmr::vector<i64> integers;
+            std::pmr::vector<double> reals;
+            // Text: słownik i numery słów.
+            std::pmr::unordered_map<std::pmr::string, u32, Hash, std::equal_to<>> dictionary;
+            std::pmr::vector<StringView> words;
+            std::pmr::vector<u32> ids;
+            // Blob: bajty i offsety.
+            std::pmr::vector<u8> bytes;
+            std::pmr::vector<u32> offsets;
+        };
+        std::pmr::vector<Column> columns_;
+        size_t rows_{};
+        size_t column_{};
+        size_t bytes_{};
+
+        Column& next(Type type);
+        void promote(Column& column, Type type);
+        void word(Column& column, StringView text);
+    };
+}
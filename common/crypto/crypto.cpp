@@ -3,12 +3,15 @@
 //
 
 #include "crypto.h"
+#include "keypool.h"
 
 using namespace std::string_literals;
 
 namespace bee::crypto {
     Botan::System_RNG rng;
 
+    Crypto::Crypto() : rsa_private_key_{KeyPool::self().take()} {}
+
     SecVector<u8> Crypto::RandomBytes(size_t const nbytes) noexcept {
         return rng.random_vec<SecVector<u8>>(nbytes);
     }
@@ -44,12 +44,19 @@
 #include <botan/base64.h>
 #include <botan/x509_key.h>
 #include <ranges>
+#include <memory>
+#include <array>
+#include <bit>
+#include <cstring>
 #include <boost/exception/exception.hpp>
+#include "../socket/logger.h"
 
 namespace bee::crypto {
     extern Botan::System_RNG rng;
 
     using u8 = uint8_t;
+    using u32 = uint32_t;
+    using u64 = uint64_t;
     using i8 = int8_t;
     using String = std::string;
     using StringView = std::string_view;
@@ -83,23 +90,62 @@ namespace bee::crypto {
         return Botan::hex_encode(data);
     }
 
+    /// Sposób uwierzytelniania komunikatów.
+    enum class Auth : u8 {
+        Signed,     // AES-GCM + sygnatura RSA każdego komunikatu
+        Aead,       // tylko znacznik AES-GCM, numer komunikatu jako dane powiązane (AD)
+    };
+
+    /// Strona połączenia - każda używa innej przestrzeni wartości nonce
+    /// (obie strony szyfrują tym samym kluczem AES).
+    enum class Side : u32 {
+        Client,
+        Server,
+    };
+
     /*------- Crypto:
+    Obiekty szyfrujące (AES-GCM z ustawionym kluczem, podpisujący,
+    weryfikujący) tworzone są raz na połączenie i używane dla każdego
+    komunikatu. Nie są bezpieczne wątkowo - komunikaty jednego połączenia
+    szyfrujemy (i odszyfrowujemy) po kolei.
     ---------------------------------------------------------------*/
     class Crypto {
         static constexpr auto RSA_ALGO = "EME-OAEP(SHA-256,MGF1)";
         static constexpr auto SIGN_ALGO = "PKCS1v15(SHA-256)";
         static constexpr size_t SIGNATURE_SIZE = 256;
-        static constexpr size_t AES_KEY_SIZE = 32;
         static constexpr size_t AES_NONCE_SIZE = 12;
 
-        UniquePtr<Botan::Private_Key> rsa_private_key_{};
+        std::shared_ptr<Botan::Private_Key const> rsa_private_key_{};
         UniquePtr<Botan::Public_Key> rsa_buddy_public_key_{};
         Option<SecVector<u8>> aes_key_{};
+        Auth auth_{Auth::Signed};
+        // Numery komunikatów wysłanych i odebranych (tryb Aead).
+        // Komunikaty muszą być szyfrowane w kolejności, w jakiej trafiają do gniazda.
+        mutable u64 send_seq_{};
+        mutable u64 recv_seq_{};
+
+        // Kontekst sesji.
+        UniquePtr<Botan::AEAD_Mode> encryptor_{};
+        UniquePtr<Botan::AEAD_Mode> decryptor_{};
+        mutable UniquePtr<Botan::PK_Signer> signer_{};
+        UniquePtr<Botan::PK_Verifier> verifier_{};
+        // Nonce: [strona (4 bajty)][licznik (8 bajtów)] - nigdy się nie powtarza dla danego klucza.
+        Side side_{Side::Client};
+        mutable u64 nonce_counter_{};
+        // Znacznik GCM odebranego komunikatu (open), bufor używany ponownie.
+        mutable SecVector<u8> tag_{};
 
     public:
-        Crypto() {
-            rsa_private_key_ = std::make_unique<Botan::RSA_PrivateKey>(rng, 2048);
-        }
+        static constexpr size_t AES_KEY_SIZE = 32;
+        static constexpr size_t AES_TAG_SIZE = 16;
+        /// Miejsce, które trzeba zostawić przed tekstem jawnym dla seal (sygnatura + nonce).
+        static constexpr size_t HEADROOM = SIGNATURE_SIZE + AES_NONCE_SIZE;
+
+        /// Klucz jednorazowy z puli (KeyPool).
+        Crypto();
+        /// Wskazany klucz (np. stały klucz serwera).
+        explicit Crypto(std::shared_ptr<Botan::Private_Key const> key) noexcept
+            : rsa_private_key_{std::move(key)} {}
 
         ~Crypto() = default;
         Crypto(Crypto const&) = delete;
@@ -107,8 +153,19 @@ namespace bee::crypto {
         Crypto(Crypto&&) = default;
         Crypto& operator=(Crypto&&) = default;
 
+        /// Strona połączenia (wpływa na wartości nonce).
+        void side(Side const side) noexcept { side_ = side; }
+
+        /// Ustawienie sposobu uwierzytelniania (po uzgodnieniu w init).
+        void auth(Auth const mode) noexcept { auth_ = mode; }
+        [[nodiscard]] Auth auth() const noexcept { return auth_; }
+
         /// Zaszyfrowanie komunikatu.
         [[nodiscard]] Option<SecVector<u8>> encrypt(Span<const u8> const plain_message) const noexcept {
+            if (auth_ == Auth::Aead) {
+                auto const ad = sequence(send_seq_++);
+                return encryptAES(plain_message, ad);
+            }
             if (auto const encrypted_message = encryptAES(plain_message)) {
                 auto message = encrypted_message.value();
                 return sign(message);
@@ -116,15 +173,91 @@ namespace bee::crypto {
             return {};
         }
 
+        /// Zaszyfrowanie komunikatu w miejscu, bez kopiowania.
+        /// \param buffer Bufor: [HEADROOM wolnych bajtów][tekst jawny od offset], po wywołaniu
+        ///               szyfrogram zastępuje tekst jawny, a za nim dopisywany jest znacznik GCM.
+        /// \param offset Początek tekstu jawnego (co najmniej HEADROOM).
+        /// \return Fragment bufora z gotowym komunikatem: [sygnatura][nonce][szyfrogram][znacznik].
+        [[nodiscard]] Option<Span<u8>> seal(SecVector<u8>& buffer, size_t const offset) const noexcept {
+            if (offset < HEADROOM or offset > buffer.size())
+                return {};
+            if (!aes_key_)
+                return Span{buffer}.subspan(offset);
+
+            try {
+                auto const nonce = nextNonce();
+                auto const ad = sequence(auth_ == Auth::Aead ? send_seq_++ : 0);
+                encryptor_->set_associated_data(auth_ == Auth::Aead ? Span<const u8>{ad} : Span<const u8>{});
+                encryptor_->start(nonce);
+                encryptor_->finish(buffer, offset);
+
+                auto start = offset - AES_NONCE_SIZE;
+                std::memcpy(buffer.data() + start, nonce.data(), AES_NONCE_SIZE);
+                if (auth_ == Auth::Signed) {
+                    auto const signature = createSignature(Span{buffer}.subspan(start));
+                    start -= SIGNATURE_SIZE;
+                    std::memcpy(buffer.data() + start, signature.data(), SIGNATURE_SIZE);
+                }
+                return Span{buffer}.subspan(start);
+            }
+            catch (Botan::Exception const& e) {
+                Logger::error("Error: {}", e.what());
+            }
+            return {};
+        }
+
+        /// Sprawdzenie i odszyfrowanie komunikatu w miejscu, bez kopiowania (odwrotność seal).
+        /// \param message Odebrany komunikat: [sygnatura][nonce][szyfrogram][znacznik].
+        /// \return Fragment komunikatu z tekstem jawnym lub nic (komunikat nie przeszedł weryfikacji).
+        ///         Jeśli jest klucz AES, za tekstem jawnym są bajty dawnego znacznika (można je nadpisać).
+        [[nodiscard]] Option<Span<u8>> open(Span<u8> message) const noexcept {
+            if (!aes_key_)
+                return message;
+
+            try {
+                if (auth_ == Auth::Signed) {
+                    if (message.size() < SIGNATURE_SIZE)
+                        return {};
+                    if (not verifySignature(message.first(SIGNATURE_SIZE), message.subspan(SIGNATURE_SIZE)))
+                        return {};
+                    message = message.subspan(SIGNATURE_SIZE);
+                }
+                if (message.size() < AES_NONCE_SIZE + AES_TAG_SIZE)
+                    return {};
+
+                auto const nonce = message.first(AES_NONCE_SIZE);
+                auto const cipher = message.subspan(AES_NONCE_SIZE, message.size() - AES_NONCE_SIZE - AES_TAG_SIZE);
+                auto const tag = message.last(AES_TAG_SIZE);
+                auto const ad = sequence(auth_ == Auth::Aead ? recv_seq_++ : 0);
+
+                decryptor_->set_associated_data(auth_ == Auth::Aead ? Span<const u8>{ad} : Span<const u8>{});
+                decryptor_->start(nonce);
+                decryptor_->process(cipher);
+                // Do finish trafia sam znacznik - jego niezgodność kończy się wyjątkiem.
+                tag_.assign(tag.begin(), tag.end());
+                decryptor_->finish(tag_);
+                return cipher;
+            }
+            catch (Botan::Exception const& e) {
+                Logger::error("Error: {}", e.what());
+            }
+            return {};
+        }
+
         /// Odszyfrowanie komunikatu.
         [[nodiscard]] Option<SecVector<u8>> decrypt(Span<u8> const signed_message) const noexcept {
             // std::println("Decrypting message...");
             try {
+                if (auth_ == Auth::Aead) {
+                    // Komunikat z innym numerem (powtórzony, pominięty, zamieniony) nie przejdzie weryfikacji GCM.
+                    auto const ad = sequence(recv_seq_++);
+                    return decryptAES(signed_message, ad);
+                }
                 if (auto const message = verify(signed_message))
                     return decryptAES(*message);
             }
             catch (Botan::Exception const&e) {
-                std::println(std::cerr, "Error: {}", e.what());
+                Logger::error("Error: {}", e.what());
             }
             return {};
         }
@@ -138,7 +271,10 @@ namespace bee::crypto {
         /// Utworzenie klucza publicznego RSA partnera z BER.
         bool setBuddyRSAPublicKey(StringView const keyBER) {
             rsa_buddy_public_key_ = Botan::X509::load_key(Botan::base64_decode(keyBER));
-            return rsa_buddy_public_key_ ? true : false;
+            if (not rsa_buddy_public_key_)
+                return false;
+            verifier_ = std::make_unique<Botan::PK_Verifier>(*rsa_buddy_public_key_, SIGN_ALGO);
+            return true;
         }
 
         /// Zwraca publiczny klucz RSA jako BER.
@@ -174,42 +310,43 @@ namespace bee::crypto {
         /// \return Wygenerowany klucz.
         Option<SecVector<u8>> generateAESKey() {
             aes_key_ = rng.random_vec<SecVector<u8>>(AES_KEY_SIZE);
+            prepareAES();
             return aes_key_;
         }
 
         /// Klucz AES jest zadany z zewnątrz.
         void setAESKey(SecVector<u8>&& key) {
             aes_key_ = std::move(key);
+            prepareAES();
         }
 
         /// Szyfrowanie-AES wskazanych bajtów.
-        [[nodiscard]] Option<SecVector<u8>> encryptAES(Span<const u8> const data) const {
+        /// \param ad Dane powiązane - nie są przesyłane, ale są uwierzytelniane.
+        [[nodiscard]] Option<SecVector<u8>> encryptAES(Span<const u8> const data, Span<const u8> const ad = {}) const {
             if (!aes_key_)
                 // Jeśli nie ma klucza szyfrowania-AES, to nic nie robimy i zwracamy to, co przyszło bez zmian.
                 return As<SecVector<u8>>(data);
 
-            auto const encryptor_{ Botan::AEAD_Mode::create_or_throw("AES-256/GCM", Botan::Cipher_Dir::Encryption) };
-
-            // Nonce jest generowane losowo za każdym razem od nowa.
-            // Później jest dołączany do zaszyfrowanej wiadomości.
+            // Nonce to kolejna wartość licznika (bez wywołania RNG),
+            // jest dołączany do zaszyfrowanej wiadomości.
             // Zwracana wiadomość: nonce + zaszyfrowane dane.
-            auto const nonce = rng.random_vec<SecVector<u8>>(AES_NONCE_SIZE);
+            auto const nonce = nextNonce();
 
             SecVector<u8> buffer{};
             buffer.reserve(AES_NONCE_SIZE + data.size() + encryptor_->output_length(data.size()));
             std::copy_n(nonce.data(), AES_NONCE_SIZE, std::back_inserter(buffer));
             std::copy_n(data.data(), data.size(), std::back_inserter(buffer));
 
-            encryptor_->set_key(*aes_key_);
+            encryptor_->set_associated_data(ad);
             encryptor_->start(nonce);
-            encryptor_->finish(buffer, AES_NONCE_SIZE); // nonce omijamy, nie szyfrujemy, to losowe bajty.
+            encryptor_->finish(buffer, AES_NONCE_SIZE); // nonce omijamy, nie szyfrujemy.
 
-            buffer.shrink_to_fit();
             return buffer;
         }
 
         /// Odszyfrowanie-AES wskazanych bajtów.
-        [[nodiscard]] Option<SecVector<u8>> decryptAES(Span<const u8> const data) const {
+        /// \param ad Dane powiązane użyte przy szyfrowaniu.
+        [[nodiscard]] Option<SecVector<u8>> decryptAES(Span<const u8> const data, Span<const u8> const ad = {}) const {
             if (!aes_key_)
                 // Jeśli nie ma klucza szyfrowania-AES, to nic nie robimy i zwracamy to, co przyszło bez zmian.
                 return As(data);
@@ -218,7 +355,6 @@ namespace bee::crypto {
                 // To jest błąd, nic nie zwracamy.
                 return {};
 
-            auto const decryptor_{ Botan::AEAD_Mode::create_or_throw("AES-256/GCM", Botan::Cipher_Dir::Decryption)};
             auto const nonce = data.first(AES_NONCE_SIZE);
             auto const cipher = data.subspan(AES_NONCE_SIZE);
 
@@ -226,11 +362,10 @@ namespace bee::crypto {
             buffer.reserve(cipher.size() + decryptor_->output_length(cipher.size()));
             std::copy_n(cipher.begin(), cipher.size(), std::back_inserter(buffer));
 
-            decryptor_->set_key(*aes_key_);
+            decryptor_->set_associated_data(ad);
             decryptor_->start(nonce);
             decryptor_->finish(buffer);
 
-            buffer.shrink_to_fit();
             return As(buffer);
         }
 
@@ -246,6 +381,9 @@ namespace bee::crypto {
 
         [[nodiscard]] Option<SecVector<u8>> verify(Span<u8> const data) const {
             auto const retv = split(data);
+            if (!retv)
+                // Komunikat krótszy niż sygnatura.
+                return {};
             auto&& [signature, message] = retv.value();
             if (verifySignature(signature, message))
                 return As(message);
@@ -257,23 +395,47 @@ namespace bee::crypto {
         /// Sygnaturę tworzymy swoim kluczem prywatnym.
         /// Partner sprawdzi to naszym kluczem publicznym.
         [[nodiscard]] Vector<u8> createSignature(Span<u8> const message) const {
-            auto const signer = std::make_unique<Botan::PK_Signer>(*rsa_private_key_, rng, SIGN_ALGO);
-            signer->update(message);
-            return signer->signature(rng);
+            if (not signer_)
+                signer_ = std::make_unique<Botan::PK_Signer>(*rsa_private_key_, rng, SIGN_ALGO);
+            signer_->update(message);
+            return signer_->signature(rng);
         }
 
         /// Weryfikacja sygnatury.
         /// Partner utworzył sygnaturę swoim kluczem prywatnym.
         /// My weryfikujemy jego kluczem publicznym.
         [[nodiscard]] bool verifySignature(Span<const u8> const signature, Span<const u8> const message) const {
-            auto const verifier = std::make_unique<Botan::PK_Verifier>(*rsa_buddy_public_key_, SIGN_ALGO);
-            verifier->update(message);
-            return verifier->check_signature(signature);
+            verifier_->update(message);
+            return verifier_->check_signature(signature);
         }
 
         static SecVector<u8> RandomBytes(size_t nbytes) noexcept;
 
     private:
+        /// Utworzenie szyfrów AES-GCM dla bieżącego klucza (raz na połączenie).
+        void prepareAES() {
+            encryptor_ = Botan::AEAD_Mode::create_or_throw("AES-256/GCM", Botan::Cipher_Dir::Encryption);
+            decryptor_ = Botan::AEAD_Mode::create_or_throw("AES-256/GCM", Botan::Cipher_Dir::Decryption);
+            encryptor_->set_key(*aes_key_);
+            decryptor_->set_key(*aes_key_);
+            nonce_counter_ = 0;
+        }
+
+        /// Kolejna wartość nonce.
+        std::array<u8, AES_NONCE_SIZE> nextNonce() const noexcept {
+            std::array<u8, AES_NONCE_SIZE> nonce{};
+            auto const side = static_cast<u32>(side_);
+            auto const counter = nonce_counter_++;
+            std::memcpy(nonce.data(), &side, sizeof(side));
+            std::memcpy(nonce.data() + sizeof(side), &counter, sizeof(counter));
+            return nonce;
+        }
+
+        /// Numer komunikatu jako bajty danych powiązanych.
+        static std::array<u8, sizeof(u64)> sequence(u64 const n) noexcept {
+            return std::bit_cast<std::array<u8, sizeof(u64)>>(n);
+        }
+
         /// Połączenie bajtów komunikatu i bajtów sygnatury w jeden NOWY wektor bajtów.
         /// \remark W zwracanym ciągu bajtów najpierw jest sygnatura, a za nią komunikat.
         /// \param signature Bajty sygnatury,
@@ -0,0 +1,141 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "keypool.h"
+#include <botan/pkcs8.h>
+#include <botan/data_src.h>
+#include <cerrno>
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace bee::crypto {
+
+    void KeyPool::start(size_t const capacity) {
+        std::lock_guard lock{mutex_};
+        run(capacity);
+    }
+
+    UniquePtr<Botan::Private_Key> KeyPool::take() {
+        {
+            std::lock_guard lock{mutex_};
+            if (not started_)
+                run(DefaultCapacity);
+            if (not keys_.empty()) {
+                auto key = std::move(keys_.front());
+                keys_.pop_front();
+                cv_.notify_one();
+                return key;
+            }
+        }
+        return generate();
+    }
+
+    /// Wywoływana z założoną blokadą mutex_.
+    void KeyPool::run(size_t const capacity) {
+        started_ = true;
+        capacity_ = capacity;
+        if (not worker_.joinable() && capacity_ > 0)
+            worker_ = std::jthread{[this](std::stop_token const& token) { loop(token); }};
+        cv_.notify_one();
+    }
+
+    void KeyPool::loop(std::stop_token const& token) {
+        while (true) {
+            {
+                std::unique_lock lock{mutex_};
+                if (not cv_.wait(lock, token, [this] { return keys_.size() < capacity_; }))
+                    return;
+            }
+            // Generowanie (długie) poza blokadą.
+            auto key = generate();
+            std::lock_guard lock{mutex_};
+            keys_.push_back(std::move(key));
+        }
+    }
+
+    bool KeyPool::loadIdentity(String const& path) noexcept {
+        try {
+            std::shared_ptr<Botan::Private_Key const> key{};
+            if (fs::exists(path)) {
+                Botan::DataSource_Stream source{path};
+                key = Botan::PKCS8::load_key(source);
+            } else {
+                key = generate();
+                if (not store(path, *key))
+                    return {};
+            }
+            std::lock_guard lock{mutex_};
+            identity_ = std::move(key);
+            return true;
+        }
+        catch (std::exception const& e) {
+            Logger::error("Error: {} ({})", e.what(), path);
+        }
+        return {};
+    }
+
+    /// Zapis nowego klucza. Plik tworzony jest od razu z prawami 0600 (bez okna,
+    /// w którym inni mogą go czytać) i tylko wtedy, gdy jeszcze nie istnieje.
+    bool KeyPool::store(String const& path, Botan::Private_Key const& key) {
+        auto const pem = Botan::PKCS8::PEM_encode(key);
+        auto const fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, S_IRUSR | S_IWUSR);
+        if (fd == -1) {
+            Logger::error("Error: {} ({})", std::make_error_code(Errc{errno}).message(), path);
+            return {};
+        }
+
+        auto ptr = pem.data();
+        auto nleft = pem.size();
+        while (nleft > 0) {
+            auto const nwritten = ::write(fd, ptr, nleft);
+            if (nwritten < 0) {
+                if (errno == EINTR)
+                    continue;
+                Logger::error("Error: {} ({})", std::make_error_code(Errc{errno}).message(), path);
+                ::close(fd);
+                ::unlink(path.c_str());
+                return {};
+            }
+            nleft -= nwritten;
+            ptr += nwritten;
+        }
+        ::close(fd);
+        return true;
+    }
+
+    std::shared_ptr<Botan::Private_Key const> KeyPool::identity() {
+        std::lock_guard lock{mutex_};
+        if (not identity_)
+            identity_ = generate();
+        return identity_;
+    }
+}
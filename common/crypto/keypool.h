@@ -0,0 +1,98 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "crypto.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace bee::crypto {
+
+    /*------- KeyPool:
+    Klucze RSA dla połączeń.
+    - serwer ma jeden stały klucz (identity), wczytywany z pliku
+      lub generowany i zapisywany przy pierwszym uruchomieniu,
+    - klucze jednorazowe (np. klientów) generowane są z wyprzedzeniem
+      przez wątek w tle, tak aby init() nie czekał na generowanie.
+    -------------------------------------------------------------------*/
+    class KeyPool final {
+        static constexpr size_t RSA_BITS = 2048;
+        /// Liczba kluczy utrzymywanych w puli, gdy nie wywołano start().
+        static constexpr size_t DefaultCapacity = 4;
+
+        std::mutex mutex_{};
+        std::condition_variable_any cv_{};
+        std::deque<UniquePtr<Botan::Private_Key>> keys_{};
+        size_t capacity_{};
+        bool started_{};
+        std::jthread worker_{};
+        std::shared_ptr<Botan::Private_Key const> identity_{};
+
+        KeyPool() = default;
+    public:
+        KeyPool(KeyPool const&) = delete;
+        KeyPool& operator=(KeyPool const&) = delete;
+        KeyPool(KeyPool&&) = delete;
+        KeyPool& operator=(KeyPool&&) = delete;
+        ~KeyPool() = default;
+
+        static KeyPool& self() noexcept {
+            static KeyPool pool{};
+            return pool;
+        }
+
+        /// Uruchomienie wątku, który utrzymuje w puli wskazaną liczbę gotowych kluczy.
+        void start(size_t capacity);
+
+        /// Pobranie klucza jednorazowego.
+        /// Pierwsze pobranie uruchamia pulę (DefaultCapacity), jeśli nie zrobiło tego start().
+        /// Jeśli pula jest pusta, klucz generowany jest od razu.
+        [[nodiscard]] UniquePtr<Botan::Private_Key> take();
+
+        /// Wczytanie klucza serwera z pliku (PKCS#8, PEM).
+        /// Jeśli pliku nie ma, klucz jest generowany i zapisywany
+        /// (plik tworzony od razu z prawami tylko dla właściciela).
+        /// \return Czy klucz jest gotowy.
+        bool loadIdentity(String const& path) noexcept;
+
+        /// Stały klucz serwera. Jeśli nie był wczytany, generowany jest (raz) tylko w pamięci.
+        [[nodiscard]] std::shared_ptr<Botan::Private_Key const> identity();
+
+        static UniquePtr<Botan::Private_Key> generate() {
+            return std::make_unique<Botan::RSA_PrivateKey>(rng, RSA_BITS);
+        }
+
+    private:
+        void run(size_t capacity);
+        void loop(std::stop_token const& token);
+        static bool store(String const& path, Botan::Private_Key const& key);
+    };
+}
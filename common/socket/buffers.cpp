@@ -0,0 +1,75 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "buffers.h"
+#include <bit>
+
+namespace bee {
+
+    void BufferPool::resize(Vector<u8>& buffer, size_t const size) {
+        if (size > buffer.capacity()) {
+            if (auto const i = index(size); i < Classes) {
+                Vector<u8> fresh{};
+                {
+                    auto& cls = classes_[i];
+                    std::lock_guard lock{cls.mutex};
+                    if (not cls.free.empty()) {
+                        fresh = std::move(cls.free.back());
+                        cls.free.pop_back();
+                    }
+                }
+                if (fresh.capacity() == 0)
+                    fresh.reserve(size_t{1} << (i + MinShift));
+                give(buffer);
+                buffer = std::move(fresh);
+            }
+        }
+        buffer.resize(size);
+    }
+
+    void BufferPool::give(Vector<u8>& buffer) noexcept {
+        auto const capacity = buffer.capacity();
+        if (capacity >= (size_t{1} << MinShift)) {
+            // Bufor trafia do największej klasy, którą w całości pokrywa.
+            auto const i = std::min<size_t>(std::bit_width(capacity) - 1, MaxShift) - MinShift;
+            auto& cls = classes_[i];
+            std::lock_guard lock{cls.mutex};
+            if (cls.free.size() < std::max<size_t>(ClassBytes >> (i + MinShift), 1)) {
+                buffer.clear();
+                cls.free.push_back(std::move(buffer));
+            }
+        }
+        Vector<u8>{}.swap(buffer);
+    }
+
+    size_t BufferPool::index(size_t const size) noexcept {
+        if (size <= (size_t{1} << MinShift))
+            return 0;
+        return std::bit_width(size - 1) - MinShift;
+    }
+}
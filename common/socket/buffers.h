@@ -0,0 +1,85 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "../../shared4cx/types.h"
+#include <array>
+#include <mutex>
+
+namespace bee {
+
+    /*------- BufferPool:
+    Bufory ramek wspólne dla wszystkich połączeń, w klasach rozmiarów
+    (potęgi dwójki od 4 KiB). Połączenie bierze bufor, gdy jego własny
+    jest za mały, i oddaje go przy zamknięciu lub gdy bufor jest duży
+    (Large) - nowe połączenia i rzadkie duże ramki nie alokują pamięci,
+    a bezczynne połączenia nie trzymają dużych buforów.
+    -------------------------------------------------------------------*/
+    class BufferPool final {
+        static constexpr size_t MinShift = 12;      // 4 KiB
+        static constexpr size_t MaxShift = 26;      // 64 MiB
+        static constexpr size_t Classes = MaxShift - MinShift + 1;
+        static constexpr size_t ClassBytes = 16 * 1024 * 1024;     // najwięcej pamięci w jednej klasie
+
+        struct Class {
+            std::mutex mutex{};
+            Vector<Vector<u8>> free{};
+        };
+        std::array<Class, Classes> classes_{};
+
+        BufferPool() = default;
+    public:
+        /// Bufory większe od tego wracają do puli zaraz po użyciu (trim).
+        static constexpr size_t Large = 1024 * 1024;
+
+        BufferPool(BufferPool const&) = delete;
+        BufferPool& operator=(BufferPool const&) = delete;
+
+        static BufferPool& self() noexcept {
+            static BufferPool pool{};
+            return pool;
+        }
+
+        /// Zmiana rozmiaru bufora. Za mały bufor wymieniany jest na bufor z puli
+        /// (stary wraca do puli), zawartość nie jest zachowywana.
+        void resize(Vector<u8>& buffer, size_t size);
+
+        /// Zwrot bufora do puli (po wywołaniu bufor jest pusty).
+        void give(Vector<u8>& buffer) noexcept;
+
+        /// Zwrot bufora, jeśli jest duży (Large).
+        void trim(Vector<u8>& buffer) noexcept {
+            if (buffer.capacity() > Large)
+                give(buffer);
+        }
+
+    private:
+        /// Klasa, do której mieści się size bajtów (Classes - większy od największej).
+        static size_t index(size_t size) noexcept;
+    };
+}
@@ -0,0 +1,101 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "compress.h"
+#include "buffers.h"
+#if defined(BEE_WITH_ZSTD)
+#include <zstd.h>
+#endif
+
+namespace bee {
+    // Szybki poziom - kompresja nie może kosztować więcej niż oszczędza na przesyłaniu i szyfrowaniu.
+    [[maybe_unused]] static constexpr int Level = 1;
+
+#if defined(BEE_WITH_ZSTD)
+
+    Compressor::~Compressor() {
+        if (decompress_)
+            ZSTD_freeDCtx(static_cast<ZSTD_DCtx*>(ctx_));
+        else
+            ZSTD_freeCCtx(static_cast<ZSTD_CCtx*>(ctx_));
+    }
+
+    size_t Compressor::bound(size_t const size) noexcept {
+        return ZSTD_compressBound(size);
+    }
+
+    Option<size_t> Compressor::compress(Span<const u8> const text, Span<u8> const out) noexcept {
+        if (not ctx_) {
+            auto const cctx = ZSTD_createCCtx();
+            if (not cctx)
+                return {};
+            ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, Level);
+            ctx_ = cctx;
+        }
+        auto const n = ZSTD_compress2(static_cast<ZSTD_CCtx*>(ctx_), out.data(), out.size(), text.data(), text.size());
+        if (ZSTD_isError(n) or n >= text.size())
+            return {};
+        return n;
+    }
+
+    Option<Span<u8>> Compressor::decompress(Span<const u8> const data, Vector<u8>& buffer, size_t const limit) noexcept {
+        if (not ctx_) {
+            if (ctx_ = ZSTD_createDCtx(); not ctx_)
+                return {};
+        }
+        // ZSTD_compress2 zapisuje rozmiar danych w nagłówku ramki.
+        auto const size = ZSTD_getFrameContentSize(data.data(), data.size());
+        if (size == ZSTD_CONTENTSIZE_ERROR or size == ZSTD_CONTENTSIZE_UNKNOWN or size > limit)
+            return {};
+        BufferPool::self().trim(buffer);
+        BufferPool::self().resize(buffer, size + 1);
+        auto const n = ZSTD_decompressDCtx(static_cast<ZSTD_DCtx*>(ctx_), buffer.data(), size, data.data(), data.size());
+        if (ZSTD_isError(n) or n != size)
+            return {};
+        buffer[n] = 0;
+        return Span<u8>{buffer.data(), n};
+    }
+
+#else
+
+    Compressor::~Compressor() = default;
+
+    size_t Compressor::bound(size_t const size) noexcept {
+        return size;
+    }
+
+    Option<size_t> Compressor::compress(Span<const u8>, Span<u8>) noexcept {
+        return {};
+    }
+
+    Option<Span<u8>> Compressor::decompress(Span<const u8>, Vector<u8>&, size_t) noexcept {
+        return {};
+    }
+
+#endif
+}
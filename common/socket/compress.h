@@ -0,0 +1,79 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "../../shared4cx/types.h"
+
+namespace bee {
+
+    /// Kompresja komunikatów (przed szyfrowaniem - szyfrogramu nie da się już skompresować).
+    enum class Compression : u8 {
+        None,
+        Zstd,       // dostępna po zbudowaniu z WITH_ZSTD
+    };
+
+    /// Najlepsza kompresja, z którą program został zbudowany.
+    constexpr Compression SupportedCompression =
+#if defined(BEE_WITH_ZSTD)
+        Compression::Zstd;
+#else
+        Compression::None;
+#endif
+
+    /*------- Compressor:
+    Kompresja komunikatów jednego kierunku połączenia.
+    Kontekst zstd tworzony jest raz i używany dla kolejnych ramek.
+    Kompresja i dekompresja mają osobne obiekty - zapis i odczyt
+    połączenia mogą działać równolegle.
+    -------------------------------------------------------------------*/
+    class Compressor final {
+        void* ctx_{};
+        bool decompress_{};
+    public:
+        /// Komunikaty krótsze od progu nie są kompresowane.
+        static constexpr size_t Threshold = 512;
+
+        explicit Compressor(bool const decompress) noexcept : decompress_{decompress} {}
+        ~Compressor();
+        Compressor(Compressor const&) = delete;
+        Compressor& operator=(Compressor const&) = delete;
+
+        /// Najwięcej bajtów, które może zająć skompresowany komunikat.
+        [[nodiscard]] static size_t bound(size_t size) noexcept;
+
+        /// Kompresja do wskazanego miejsca.
+        /// \param out Miejsce na wynik (co najmniej bound(text.size()) bajtów).
+        /// \return Rozmiar wyniku lub nic (błąd albo kompresja nic nie daje).
+        [[nodiscard]] Option<size_t> compress(Span<const u8> text, Span<u8> out) noexcept;
+
+        /// Dekompresja do bufora (za danymi zostaje jeden bajt zerowy).
+        /// \param limit Największy rozmiar danych po dekompresji (ochrona przed "bombą").
+        /// \return Odtworzone dane w buforze lub nic.
+        [[nodiscard]] Option<Span<u8>> decompress(Span<const u8> data, Vector<u8>& buffer, size_t limit) noexcept;
+    };
+}
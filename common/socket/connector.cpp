@@ -29,9 +29,11 @@
 #include "connector.h"
 #include "logger.h"
 #include <ranges>
+#include <cstring>
 
 namespace rg = std::ranges;
 namespace rv = rg::views;
+using Clock = std::chrono::steady_clock;
 
 namespace bee {
 
@@ -41,29 +43,124 @@ namespace bee {
      *                                                                  *
      ********************************************************************/
 
-    Result<size_t,Errc> Connector::write(String&& text) const noexcept {
-        if (not text.empty()) {
-            auto data = text
-                | rv::transform([](auto c) { return static_cast<u8>(c); })
-                | rg::to<Vector<u8>>();
-            if (auto encrypted = crypto.encrypt(data))
-                return writePackage(encrypted.value());
-        }
-        return Failure(std::errc::bad_message);
+    Result<size_t,Errc> Connector::write(StringView const text) const noexcept {
+        auto const start = Clock::now();
+        auto const bytes = pack(text);
+        if (not bytes)
+            return Failure(bytes.error());
+        auto const packed = Clock::now();
+        // Nagłówek i dane są jednym ciągłym blokiem - jeden zapis do gniazda.
+        auto const stat = writeBytes(bytes->data(), bytes->size());
+        timing_.encrypt = packed - start;
+        timing_.write = Clock::now() - packed;
+        return stat;
     }
 
-    Result<String,Errc> Connector::read() const noexcept {
-        auto const data = readPackage();
+    Result<StringView,Errc> Connector::read() const noexcept {
+        // Poprzedni komunikat nie jest już używany - duży bufor może wrócić do puli.
+        BufferPool::self().trim(rbuf_);
+        auto const data = readPackage(rbuf_);
         if (not data)
             return Failure(data.error());
+        auto const received = Clock::now();
+        auto const text = unpack(data.value());
+        timing_.read = received - arrived();
+        timing_.decrypt = Clock::now() - received;
+        return text;
+    }
 
-        if (auto message = data.value(); auto const plain = crypto.decrypt(message)) {
-            auto retv = plain.value()
-                | rv::transform([](auto const c) { return static_cast<char>(c); })
-                | rg::to<String>();
-            return retv;
+    Task<Result<size_t,Errc>> Connector::asyncWrite(EventLoop& loop, StringView const text) const noexcept {
+        auto const start = Clock::now();
+        auto const bytes = pack(text);
+        if (not bytes)
+            co_return Failure(bytes.error());
+        auto const packed = Clock::now();
+        auto const stat = co_await asyncWriteBytes(loop, bytes->data(), bytes->size());
+        timing_.encrypt = packed - start;
+        timing_.write = Clock::now() - packed;
+        co_return stat;
+    }
+
+    Task<Result<StringView,Errc>> Connector::asyncRead(EventLoop& loop) const noexcept {
+        BufferPool::self().trim(rbuf_);
+        auto const data = co_await asyncReadPackage(loop, rbuf_);
+        if (not data)
+            co_return Failure(data.error());
+        auto const received = Clock::now();
+        auto const text = unpack(data.value());
+        timing_.read = received - arrived();
+        timing_.decrypt = Clock::now() - received;
+        co_return text;
+    }
+
+    Result<Span<const u8>,Errc> Connector::pack(StringView const text) const noexcept {
+        if (text.empty())
+            return Failure(std::errc::bad_message);
+
+        // Tekst trafia do bufora tylko raz, za zarezerwowanym miejscem,
+        // i jest tam szyfrowany (bufor nie jest zwalniany pomiędzy ramkami).
+        // Przy uzgodnionej kompresji przed tekstem jest znacznik Packing,
+        // a dłuższy tekst kompresowany jest od razu do bufora ramki.
+        auto const compressed = options_.compression != Compression::None;
+        auto const offset = HEADROOM + (compressed ? 1 : 0);
+        auto const bytes = Span{reinterpret_cast<u8 const*>(text.data()), text.size()};
+
+        Option<size_t> packed{};
+        if (compressed and text.size() >= Compressor::Threshold) {
+            auto const bound = Compressor::bound(text.size());
+            wbuf_.reserve(offset + bound + crypto::Crypto::AES_TAG_SIZE);
+            wbuf_.resize(offset + bound);
+            packed = deflate_.compress(bytes, Span{wbuf_}.subspan(offset));
         }
-        return Failure(std::errc::bad_message);
+        auto const size = packed.value_or(text.size());
+        wbuf_.reserve(offset + size + crypto::Crypto::AES_TAG_SIZE);
+        wbuf_.resize(offset + size);
+        if (not packed)
+            std::memcpy(wbuf_.data() + offset, text.data(), text.size());
+        if (compressed)
+            wbuf_[HEADROOM] = packed ? Packed : Raw;
+
+        auto const body = crypto.seal(wbuf_, HEADROOM);
+        if (not body)
+            return Failure(std::errc::bad_message);
+
+        // Nagłówek (rozmiar) tuż przed zaszyfrowanym komunikatem.
+        size_t const length = body->size();
+        auto const start = body->data() - sizeof(length);
+        std::memcpy(start, &length, sizeof(length));
+        return Span<const u8>{start, sizeof(length) + length};
+    }
+
+    Span<const u8> Connector::frame(Span<const u8> const bytes) const {
+        size_t const size = bytes.size();
+        wbuf_.resize(sizeof(size) + size);
+        std::memcpy(wbuf_.data(), &size, sizeof(size));
+        std::memcpy(wbuf_.data() + sizeof(size), bytes.data(), size);
+        return wbuf_;
+    }
+
+    Result<StringView,Errc> Connector::unpack(Span<u8> const frame) const noexcept {
+        auto plain = crypto.open(frame);
+        if (not plain)
+            return Failure(std::errc::bad_message);
+
+        if (options_.compression != Compression::None) {
+            if (plain->empty())
+                return Failure(std::errc::bad_message);
+            auto const packing = plain->front();
+            plain = plain->subspan(1);
+            if (packing == Packed) {
+                plain = inflate_.decompress(plain.value(), zbuf_, maxFrame());
+                if (not plain)
+                    return Failure(std::errc::bad_message);
+            }
+            else if (packing != Raw)
+                return Failure(std::errc::bad_message);
+        }
+        // Za tekstem jest wolny bajt (znacznik GCM lub zapas bufora) - parser
+        // dostaje tekst zakończony zerem, bez kopiowania.
+        plain->data()[plain->size()] = 0;
+        return StringView{reinterpret_cast<char const*>(plain->data()), plain->size()};
     }
 
     /********************************************************************
@@ -74,30 +171,133 @@ namespace bee {
 
     bool Server::init() noexcept{
         // 1. Serwer czeka na klucz publiczny RSA klienta.
-        auto const client_public_key_ber = readText();
-        if (not client_public_key_ber) {
-            print_error(client_public_key_ber.error());
-            return {};
+        // 2. Serwer wysyła swój klucz publiczny.
+        // 3. Odczyt zaszyfrowanego klucza AES klienta.
+        while (not ready()) {
+            auto frame = readPackage();
+            if (not frame) {
+                print_error(frame.error());
+                return {};
+            }
+            auto const answer = handshake(frame.value());
+            if (not answer) {
+                print_error(answer.error());
+                return {};
+            }
+            if (auto const& bytes = answer.value()) {
+                if (auto const retv = writePackage(*bytes); not retv) {
+                    print_error(retv.error());
+                    return {};
+                }
+            }
         }
-        crypto.setBuddyRSAPublicKey(client_public_key_ber.value());
+        return true;
+    }
 
-        // 2. Serwer wysyła swój klucz publiczny.
-        if (auto const retv = writeText(crypto.RSAPublicKeyBER()); not retv) {
-            print_error(retv.error());
-            return {};
+    Task<bool> Server::asyncInit(EventLoop& loop) noexcept {
+        while (not ready()) {
+            auto frame = co_await asyncReadPackage(loop);
+            if (not frame) {
+                print_error(frame.error());
+                co_return false;
+            }
+            auto const answer = handshake(frame.value());
+            if (not answer) {
+                print_error(answer.error());
+                co_return false;
+            }
+            if (auto const& bytes = answer.value()) {
+                if (auto const retv = co_await asyncWritePackage(loop, *bytes); not retv) {
+                    print_error(retv.error());
+                    co_return false;
+                }
+            }
         }
+        co_return true;
+    }
 
-        // 3. Odczyt zaszyfrowanego klucza AES klienta.
-        auto const res = readPackage();
-        if (not res) {
-            print_error(res.error());
+    Result<Option<Vector<u8>>,Errc> Server::handshake(Span<u8> const frame) noexcept {
+        try {
+            switch (step_) {
+                case Step::BuddyKey: {
+                    // Klucz publiczny RSA klienta (BER), w odpowiedzi nasz klucz publiczny.
+                    if (not crypto.setBuddyRSAPublicKey(StringView{reinterpret_cast<char const*>(frame.data()), frame.size()}))
+                        return Failure(std::errc::bad_message);
+                    auto const ber = crypto.RSAPublicKeyBER();
+                    step_ = Step::AESKey;
+                    return Vector<u8>{ber.begin(), ber.end()};
+                }
+                case Step::AESKey: {
+                    // Klucz AES zaszyfrowany naszym kluczem publicznym,
+                    // za kluczem (jeśli klient je wysłał) propozycje ustawień sesji.
+                    constexpr auto KeySize = crypto::Crypto::AES_KEY_SIZE;
+                    auto const message = crypto.decryptRSA(frame);
+                    if (message.size() < KeySize)
+                        return Failure(std::errc::bad_message);
+
+                    crypto.setAESKey(crypto::SecVector<u8>{message.begin(), message.begin() + KeySize});
+                    step_ = Step::Ready;
+                    if (message.size() == KeySize)
+                        // Klient bez uzgadniania ustawień - zostają domyślne.
+                        return Option<Vector<u8>>{};
+
+                    options_ = policy_.accept(SessionOptions::decode(Span{message}.subspan(KeySize)));
+                    auto const answer = crypto.encryptAES(options_.encode());
+                    crypto.auth(options_.auth);
+                    return Vector<u8>{answer->begin(), answer->end()};
+                }
+                default:
+                    return Failure(std::errc::operation_not_permitted);
+            }
+        }
+        catch (Botan::Exception const& e) {
+            Logger::error("Error: {}", e.what());
+        }
+        return Failure(std::errc::bad_message);
+    }
+
+    Option<Errc> Server::process(Span<u8> const data, MessageHandler const& handler, FrameSink const& out) noexcept {
+        if (not ready()) {
+            auto const answer = handshake(data);
+            if (not answer)
+                return answer.error();
+            if (ready())
+                Logger::info("------- Client connected: {} -------", peerAddress());
+            if (auto const& bytes = answer.value(); bytes and not out(frame(*bytes)))
+                return std::errc::broken_pipe;
             return {};
         }
-        auto encrypted_key = res.value();
-        auto decrypted_key = crypto.decryptRSA(encrypted_key);
-        crypto.setAESKey(std::move(decrypted_key));
 
-        return true;
+        auto const text = unpack(data);
+        if (not text)
+            return text.error();
+
+        auto reply = handler(text.value(), options_.format, context_);
+        if (not reply)
+            return std::errc::bad_message;
+        reply_ = std::move(reply.value());
+        return {};
+    }
+
+    Option<Errc> Server::pull(FrameSink const& out) noexcept {
+        if (not reply_)
+            return {};
+
+        Option<Errc> error{};
+        auto const respond = [this, &out, &error](StringView const answer) {
+            auto const bytes = pack(answer);
+            if (not bytes)
+                error = bytes.error();
+            else if (not out(bytes.value()))
+                error = std::errc::broken_pipe;
+            return not error;
+        };
+        auto const more = reply_(respond);
+        if (not more)
+            return error.value_or(std::errc::bad_message);
+        if (not more.value())
+            reply_ = nullptr;
+        return error;
     }
 
     /********************************************************************
@@ -121,15 +321,81 @@ namespace bee {
         }
         crypto.setBuddyRSAPublicKey(publicKeyBER.value());
 
-        // 3. Generujemy klucz AES i wysyłamy go do serwera.
+        // 3. Generujemy klucz AES i wysyłamy go do serwera (razem z propozycją ustawień).
+        auto const message = keyMessage();
+        if (not message)
+            return {};
+        if (auto const res = writePackage(*message); not res) {
+            print_error(res.error());
+            return {};
+        }
+
+        // 4. Serwer odsyła ustawienia, które przyjął.
+        auto const answer = readPackage();
+        if (not answer) {
+            print_error(answer.error());
+            return {};
+        }
+        return accept(answer.value());
+    }
+
+    Task<bool> Client::asyncInit(EventLoop& loop) noexcept {
+        // Te same kroki co w init().
+        auto const ber = crypto.RSAPublicKeyBER();
+        if (auto const retv = co_await asyncWritePackage(loop, Span{reinterpret_cast<u8 const*>(ber.data()), ber.size()}); not retv) {
+            print_error(retv.error());
+            co_return false;
+        }
+
+        auto const publicKeyBER = co_await asyncReadPackage(loop);
+        if (not publicKeyBER) {
+            print_error(publicKeyBER.error());
+            co_return false;
+        }
+        crypto.setBuddyRSAPublicKey(StringView{reinterpret_cast<char const*>(publicKeyBER->data()), publicKeyBER->size()});
+
+        auto const message = keyMessage();
+        if (not message)
+            co_return false;
+        if (auto const res = co_await asyncWritePackage(loop, *message); not res) {
+            print_error(res.error());
+            co_return false;
+        }
+
+        auto const answer = co_await asyncReadPackage(loop);
+        if (not answer) {
+            print_error(answer.error());
+            co_return false;
+        }
+        co_return accept(answer.value());
+    }
+
+    Option<Vector<u8>> Client::keyMessage() {
         if (auto const aesKey = crypto.generateAESKey()) {
-            auto vec = aesKey.value();
-            auto encrypted_key = crypto.encryptRSA(vec);
-            if (auto const res = writePackage(encrypted_key); not res) {
-                print_error(res.error());
-                return {};
+            auto message = aesKey.value();
+            auto const options = proposed_.encode();
+            message.insert(message.end(), options.begin(), options.end());
+            return crypto.encryptRSA(message);
+        }
+        return {};
+    }
+
+    bool Client::accept(Span<u8> const answer) noexcept {
+        try {
+            if (auto const bytes = crypto.decryptAES(answer)) {
+                auto const accepted = SessionOptions::decode(*bytes);
+                // Serwer nie może przyjąć niczego, czego nie zaproponowaliśmy.
+                if (proposed_.accept(accepted) == accepted) {
+                    options_ = accepted;
+                    crypto.auth(options_.auth);
+                    return true;
+                }
             }
         }
-        return true;
+        catch (Botan::Exception const& e) {
+            Logger::error("Error: {}", e.what());
+        }
+        Logger::error("Session options rejected");
+        return {};
     }
-}
\ No newline at end of file
+}
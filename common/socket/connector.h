@@ -29,30 +29,108 @@
 -------------------------------------------------------------------*/
 #include "socket.h"
 #include "../crypto/crypto.h"
+#include "../crypto/keypool.h"
+#include "session.h"
+#include "buffers.h"
+#include <any>
+#include <functional>
 
 namespace bee {
+    /// Wysłanie odpowiedzi (jednej części odpowiedzi) na komunikat.
+    /// \return false - połączenie nie działa, nie należy wysyłać dalszych części.
+    using Respond = std::function<bool(StringView)>;
+    /// Źródło części odpowiedzi - każde wywołanie przekazuje kolejną część do respond.
+    /// \return Czy odpowiedź ma następne części; nic - błąd i zamknięcie połączenia.
+    using NextPart = std::function<Option<bool>(Respond const&)>;
+    /// Obsługa odszyfrowanego komunikatu (w uzgodnionym formacie). Części odpowiedzi (jedna
+    /// lub kilka, w tym samym formacie) pobierane są przez transport ze zwróconego źródła,
+    /// gdy poprzednie zostały już wysłane.
+    /// Komunikat jest w buforze połączenia (ważny tylko w czasie wywołania), zakończony bajtem zerowym.
+    /// Trzeci argument to stan połączenia należący do funkcji obsługi (Server::context).
+    /// Wynik nic oznacza błąd i zamknięcie połączenia.
+    using MessageHandler = std::function<Option<NextPart>(StringView, Format, std::any&)>;
+    /// Odbiorca kompletnych ramek do wysłania (ramka ważna tylko w czasie wywołania).
+    using FrameSink = std::function<bool(Span<const u8>)>;
 
     /*------- Connector:
     -------------------------------------------------------------------*/
     class Connector : public Socket {
     protected:
         crypto::Crypto crypto{};
+        SessionOptions options_{};
+        // Bufor ramek wysyłanych, używany ponownie dla każdej ramki:
+        // [rozmiar][miejsce na sygnaturę i nonce][tekst -> szyfrogram][znacznik].
+        mutable crypto::SecVector<u8> wbuf_{};
+        // Bufor ramek odbieranych - odszyfrowywanych w miejscu.
+        mutable Vector<u8> rbuf_{};
+        // Kompresja (SessionOptions::compression) - konteksty używane ponownie,
+        // osobne dla zapisu i odczytu. Po dekompresji komunikat jest w zbuf_.
+        mutable Compressor deflate_{false};
+        mutable Compressor inflate_{true};
+        mutable Vector<u8> zbuf_{};
     public:
+        /// Czasy ostatniego odczytu (read/asyncRead) i zapisu (write/asyncWrite) komunikatu.
+        struct Timing {
+            std::chrono::nanoseconds read{};     // dane ramki, od odczytu nagłówka (Socket::arrived)
+            std::chrono::nanoseconds decrypt{};  // odszyfrowanie i dekompresja
+            std::chrono::nanoseconds encrypt{};  // kompresja i zaszyfrowanie
+            std::chrono::nanoseconds write{};    // wysłanie ramki
+        };
+    protected:
+        mutable Timing timing_{};
+    public:
+        /// Miejsce przed tekstem jawnym w buforze ramki (nagłówek + sygnatura + nonce).
+        static constexpr size_t HEADROOM = sizeof(size_t) + crypto::Crypto::HEADROOM;
+        /// Znacznik przed tekstem jawnym, gdy uzgodniono kompresję: czy tekst jest skompresowany.
+        enum Packing : u8 { Raw, Packed };
+
         Connector() = default;
         explicit Connector(int const fd) : Socket{fd} {}
-        ~Connector() override = default;
+        /// Połączenie używające wskazanego klucza RSA (np. stałego klucza serwera).
+        explicit Connector(std::shared_ptr<Botan::Private_Key const> key) : crypto{std::move(key)} {}
+        Connector(int const fd, std::shared_ptr<Botan::Private_Key const> key) : Socket{fd}, crypto{std::move(key)} {}
+        ~Connector() override {
+            BufferPool::self().give(rbuf_);
+            BufferPool::self().give(zbuf_);
+        }
 
         virtual bool init() noexcept = 0;
-        [[nodiscard]] Result<size_t,Errc> write(std::string&& text) const noexcept;
-        [[nodiscard]] Result<String,Errc> read() const noexcept;
+        /// Ustawienia sesji (po init - uzgodnione z partnerem).
+        [[nodiscard]] SessionOptions const& options() const noexcept { return options_; }
+        /// Czasy odczytu są zmieniane tylko przez read, czasy zapisu - tylko przez write.
+        [[nodiscard]] Timing const& timing() const noexcept { return timing_; }
+        [[nodiscard]] Result<size_t,Errc> write(StringView text) const noexcept;
+        /// Odczyt i odszyfrowanie komunikatu.
+        /// \return Tekst w buforze połączenia - ważny do następnego odczytu.
+        [[nodiscard]] Result<StringView,Errc> read() const noexcept;
+
+        /// Zaszyfrowanie tekstu do postaci kompletnej ramki (z nagłówkiem), bez wysyłania.
+        /// \return Ramka w buforze połączenia - ważna do następnego wywołania pack/frame.
+        [[nodiscard]] Result<Span<const u8>,Errc> pack(StringView text) const noexcept;
+        /// Ramka (z nagłówkiem) z niezaszyfrowanych bajtów, np. w czasie uzgadniania kluczy.
+        [[nodiscard]] Span<const u8> frame(Span<const u8> bytes) const;
+        /// Odszyfrowanie ramki odebranej z gniazda, w miejscu.
+        /// \param frame Ramka, za którą jest co najmniej jeden wolny bajt (Socket::readPackage, FrameReader).
+        /// \return Tekst wewnątrz ramki, zakończony bajtem zerowym.
+        [[nodiscard]] Result<StringView,Errc> unpack(Span<u8> frame) const noexcept;
+
+        /// Wersje write/read dla korutyn (gniazdo musi być nieblokujące).
+        [[nodiscard]] Task<Result<size_t,Errc>> asyncWrite(EventLoop& loop, StringView text) const noexcept;
+        [[nodiscard]] Task<Result<StringView,Errc>> asyncRead(EventLoop& loop) const noexcept;
     };
 
     /*------- Server:
     -------------------------------------------------------------------*/
     class Server final : public Connector {
     public:
-        Server() = default;
-        explicit Server(int const fd) : Connector(fd) {}
+        // Serwer zawsze używa swojego stałego klucza, więc
+        // przyjęcie połączenia nie wymaga generowania klucza RSA.
+        Server() : Connector(crypto::KeyPool::self().identity()) {
+            crypto.side(crypto::Side::Server);
+        }
+        explicit Server(int const fd) : Connector(fd, crypto::KeyPool::self().identity()) {
+            crypto.side(crypto::Side::Server);
+        }
         ~Server() override = default;
 
         [[nodiscard]] Option<Errc> run(int const port) const noexcept {
@@ -62,6 +140,46 @@ namespace bee {
         }
 
         bool init() noexcept override;
+        /// Uzgadnianie kluczy w korutynie.
+        [[nodiscard]] Task<bool> asyncInit(EventLoop& loop) noexcept;
+
+        /// Jeden krok uzgadniania kluczy (init) dla trybu nieblokującego.
+        /// \param frame Ramka odebrana od klienta.
+        /// \return Ramka do odesłania klientowi (może jej nie być) lub błąd.
+        [[nodiscard]] Result<Option<Vector<u8>>,Errc> handshake(Span<u8> frame) noexcept;
+
+        /// Obsługa ramki odebranej w trybie nieblokującym.
+        /// Przed zakończeniem uzgadniania kluczy ramka trafia do handshake (odpowiedź od razu
+        /// idzie do out), później jest odszyfrowywana i przekazywana do funkcji obsługi.
+        /// Części odpowiedzi na komunikat pobiera pull.
+        /// \param out Odbiorca ramek do odesłania.
+        /// \return Błąd lub nic.
+        /// \remark Nie wolno przekazywać kolejnej ramki, dopóki trwa odpowiedź (replying).
+        [[nodiscard]] Option<Errc> process(Span<u8> frame, MessageHandler const& handler, FrameSink const& out) noexcept;
+
+        /// Kolejna część odpowiedzi, jako ramka przekazana do out.
+        /// Transport woła ją, gdy poprzednie ramki zostały (prawie) wysłane.
+        /// \return Błąd lub nic.
+        [[nodiscard]] Option<Errc> pull(FrameSink const& out) noexcept;
+
+        /// Czy są jeszcze części odpowiedzi do pobrania (pull).
+        [[nodiscard]] bool replying() const noexcept { return static_cast<bool>(reply_); }
+
+        /// Czy uzgadnianie kluczy zostało zakończone.
+        [[nodiscard]] bool ready() const noexcept { return step_ == Step::Ready; }
+
+        /// Ustawienia, na które serwer pozwala klientom (wspólne dla wszystkich połączeń).
+        static void policy(SessionOptions const& opt) noexcept { policy_ = opt; }
+
+        /// Stan połączenia dla funkcji obsługi komunikatów (transport go nie używa).
+        [[nodiscard]] std::any& context() noexcept { return context_; }
+
+    private:
+        enum class Step { BuddyKey, AESKey, Ready };
+        Step step_{Step::BuddyKey};
+        std::any context_{};
+        NextPart reply_{};
+        static inline SessionOptions policy_{.auth = crypto::Auth::Aead, .format = Format::Beve, .dispatch = Dispatch::Concurrent, .compression = SupportedCompression};
     };
 
     /*------- Client:
@@ -73,5 +191,18 @@ namespace bee {
         ~Client() override = default;
 
         bool init() noexcept override;
+        /// Uzgadnianie kluczy w korutynie.
+        [[nodiscard]] Task<bool> asyncInit(EventLoop& loop) noexcept;
+
+        /// Ustawienia proponowane serwerowi (przed init).
+        void propose(SessionOptions const& opt) noexcept { proposed_ = opt; }
+
+    private:
+        SessionOptions proposed_{.auth = crypto::Auth::Aead, .format = Format::Beve, .compression = SupportedCompression};
+
+        /// Klucz AES razem z propozycją ustawień, zaszyfrowany kluczem publicznym serwera.
+        [[nodiscard]] Option<Vector<u8>> keyMessage();
+        /// Przyjęcie ustawień odesłanych przez serwer.
+        [[nodiscard]] bool accept(Span<u8> answer) noexcept;
     };
 }
@@ -0,0 +1,122 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "coro.h"
+#include "logger.h"
+#include <cerrno>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/epoll.h>
+#else
+#include <sys/event.h>
+#endif
+
+namespace bee {
+
+#if defined(__linux__)
+
+    EventLoop::EventLoop() noexcept {
+        fd_ = epoll_create1(EPOLL_CLOEXEC);
+        if (fd_ == -1)
+            print_error(errno, "epoll_create1");
+    }
+
+    /// Gniazdo rejestrujemy jako jednorazowe (EPOLLONESHOT),
+    /// po wznowieniu korutyny kolejne oczekiwanie uzbraja je ponownie.
+    Option<Errc> EventLoop::watch(int const fd, Event const event, void* const coroutine) noexcept {
+        epoll_event ev{
+            .events = static_cast<u32>((event == Event::Read ? EPOLLIN | EPOLLRDHUP : EPOLLOUT) | EPOLLONESHOT),
+            .data = {.ptr = coroutine}
+        };
+        if (epoll_ctl(fd_, EPOLL_CTL_MOD, fd, &ev) == 0)
+            return {};
+        if (errno == ENOENT && epoll_ctl(fd_, EPOLL_CTL_ADD, fd, &ev) == 0)
+            return {};
+        return Errc{errno};
+    }
+
+    void EventLoop::run(std::stop_token const& token) noexcept {
+        epoll_event events[MaxEvents];
+
+        while (not stopped_ and not token.stop_requested()) {
+            auto const n = epoll_wait(fd_, events, MaxEvents, WaitTimeout);
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                print_error(errno, "epoll_wait");
+                break;
+            }
+            for (int i = 0; i < n; ++i)
+                std::coroutine_handle<>::from_address(events[i].data.ptr).resume();
+        }
+    }
+
+#else
+
+    EventLoop::EventLoop() noexcept {
+        fd_ = kqueue();
+        if (fd_ == -1)
+            print_error(errno, "kqueue");
+    }
+
+    Option<Errc> EventLoop::watch(int const fd, Event const event, void* const coroutine) noexcept {
+        struct kevent ev{};
+        EV_SET(&ev, fd, event == Event::Read ? EVFILT_READ : EVFILT_WRITE, EV_ADD | EV_ONESHOT, 0, 0, coroutine);
+        if (kevent(fd_, &ev, 1, nullptr, 0, nullptr) == 0)
+            return {};
+        return Errc{errno};
+    }
+
+    void EventLoop::run(std::stop_token const& token) noexcept {
+        struct kevent events[MaxEvents];
+        timespec const timeout{.tv_sec = 0, .tv_nsec = WaitTimeout * 1'000'000};
+
+        while (not stopped_ and not token.stop_requested()) {
+            auto const n = kevent(fd_, nullptr, 0, events, MaxEvents, &timeout);
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                print_error(errno, "kevent");
+                break;
+            }
+            for (int i = 0; i < n; ++i)
+                std::coroutine_handle<>::from_address(events[i].udata).resume();
+        }
+    }
+
+#endif
+
+    EventLoop::~EventLoop() {
+        // Korutyny, które nie zdążyły się zakończyć, niszczone są razem
+        // ze swoimi zadaniami (i zasobami, np. gniazdami klientów).
+        for (auto const root : std::exchange(roots_, {}))
+            std::coroutine_handle<>::from_address(root).destroy();
+        if (fd_ != -1)
+            ::close(fd_);
+    }
+}
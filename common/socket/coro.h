@@ -0,0 +1,215 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "../../shared4cx/types.h"
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <stop_token>
+#include <system_error>
+#include <unordered_set>
+#include <utility>
+
+namespace bee {
+
+    /*------- Task:
+    Korutyna zwracająca wartość typu T. Startuje dopiero przy co_await,
+    po zakończeniu wznawia korutynę, która na nią czekała.
+    -------------------------------------------------------------------*/
+
+    namespace detail {
+        struct PromiseBase {
+            std::coroutine_handle<> continuation{};
+
+            std::suspend_always initial_suspend() noexcept { return {}; }
+
+            struct FinalAwaiter {
+                bool await_ready() noexcept { return false; }
+                template<typename P>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept {
+                    if (auto const next = h.promise().continuation)
+                        return next;
+                    return std::noop_coroutine();
+                }
+                void await_resume() noexcept {}
+            };
+            FinalAwaiter final_suspend() noexcept { return {}; }
+
+            // Kod korutyn (tak jak reszta biblioteki) nie zgłasza wyjątków.
+            void unhandled_exception() noexcept { std::terminate(); }
+        };
+
+        template<typename T>
+        struct Promise : PromiseBase {
+            Option<T> value{};
+
+            template<typename U>
+            void return_value(U&& v) { value.emplace(std::forward<U>(v)); }
+            T result() { return std::move(*value); }
+        };
+
+        template<>
+        struct Promise<void> : PromiseBase {
+            void return_void() noexcept {}
+            void result() noexcept {}
+        };
+    }
+
+    template<typename T = void>
+    class [[nodiscard]] Task final {
+    public:
+        struct promise_type : detail::Promise<T> {
+            Task get_return_object() noexcept {
+                return Task{std::coroutine_handle<promise_type>::from_promise(*this)};
+            }
+        };
+        using Handle = std::coroutine_handle<promise_type>;
+
+        Task(Task&& other) noexcept : handle_{std::exchange(other.handle_, {})} {}
+        Task& operator=(Task&& other) noexcept {
+            if (this != &other) {
+                if (handle_)
+                    handle_.destroy();
+                handle_ = std::exchange(other.handle_, {});
+            }
+            return *this;
+        }
+        Task(Task const&) = delete;
+        Task& operator=(Task const&) = delete;
+        ~Task() {
+            if (handle_)
+                handle_.destroy();
+        }
+
+        bool await_ready() const noexcept { return not handle_ or handle_.done(); }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> const caller) noexcept {
+            handle_.promise().continuation = caller;
+            return handle_;
+        }
+        T await_resume() { return handle_.promise().result(); }
+
+    private:
+        Handle handle_{};
+        explicit Task(Handle const handle) noexcept : handle_{handle} {}
+    };
+
+    /*------- EventLoop:
+    Pętla zdarzeń dla korutyn (epoll na Linuksie, kqueue na macOS).
+    Korutyna czeka na gotowość gniazda do odczytu lub zapisu,
+    pętla wznawia ją w swoim wątku.
+    \remark Na jednym gnieździe może naraz czekać tylko jedna korutyna.
+    -------------------------------------------------------------------*/
+    class EventLoop final {
+    public:
+        enum class Event { Read, Write };
+
+        struct Awaiter {
+            EventLoop& loop;
+            int fd;
+            Event event;
+            Option<Errc> error{};
+
+            bool await_ready() const noexcept { return false; }
+            bool await_suspend(std::coroutine_handle<> const h) noexcept {
+                error = loop.watch(fd, event, h.address());
+                // W razie błędu nie zawieszamy korutyny.
+                return not error;
+            }
+            Option<Errc> await_resume() const noexcept { return error; }
+        };
+
+        EventLoop() noexcept;
+        ~EventLoop();
+        EventLoop(EventLoop const&) = delete;
+        EventLoop& operator=(EventLoop const&) = delete;
+        EventLoop(EventLoop&&) = delete;
+        EventLoop& operator=(EventLoop&&) = delete;
+
+        /// Oczekiwanie na dane do odczytu.
+        [[nodiscard]] Awaiter readable(int const fd) noexcept { return {*this, fd, Event::Read}; }
+        /// Oczekiwanie na możliwość zapisu.
+        [[nodiscard]] Awaiter writable(int const fd) noexcept { return {*this, fd, Event::Write}; }
+
+        /// Pętla zdarzeń, działa do wywołania stop() lub zatrzymania tokenem.
+        void run(std::stop_token const& token = {}) noexcept;
+        void stop() noexcept { stopped_ = true; }
+
+        /// Rejestracja korutyny uruchomionej przez spawn (niezakończone niszczy destruktor).
+        void adopt(std::coroutine_handle<> const root) { roots_.insert(root.address()); }
+        void forget(std::coroutine_handle<> const root) noexcept { roots_.erase(root.address()); }
+
+    private:
+        static constexpr int MaxEvents = 64;
+        static constexpr int WaitTimeout = 250; // ms
+
+        int fd_{-1};
+        std::atomic_bool stopped_{};
+        std::unordered_set<void*> roots_{};
+
+        Option<Errc> watch(int fd, Event event, void* coroutine) noexcept;
+    };
+
+    namespace detail {
+        /// Korutyna bez właściciela - sama się niszczy po zakończeniu.
+        /// Do końca działania jest zarejestrowana w pętli zdarzeń,
+        /// która niszczy ją, jeśli zostanie zamknięta wcześniej.
+        struct Detached {
+            struct promise_type {
+                EventLoop& loop;
+
+                promise_type(EventLoop& loop, Task<>&) noexcept : loop{loop} {}
+
+                Detached get_return_object() {
+                    loop.adopt(std::coroutine_handle<promise_type>::from_promise(*this));
+                    return {};
+                }
+                std::suspend_never initial_suspend() noexcept { return {}; }
+
+                struct FinalAwaiter {
+                    bool await_ready() noexcept { return false; }
+                    bool await_suspend(std::coroutine_handle<promise_type> const h) noexcept {
+                        h.promise().loop.forget(h);
+                        // Bez zawieszenia - ramka korutyny zostanie zwolniona.
+                        return false;
+                    }
+                    void await_resume() noexcept {}
+                };
+                FinalAwaiter final_suspend() noexcept { return {}; }
+
+                void return_void() noexcept {}
+                void unhandled_exception() noexcept { std::terminate(); }
+            };
+        };
+    }
+
+    /// Uruchomienie zadania "w tle" pętli loop (do pierwszego zawieszenia działa w bieżącym wątku).
+    inline detail::Detached spawn(EventLoop& loop, Task<> task) {
+        co_await std::move(task);
+    }
+}
@@ -0,0 +1,146 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "frame.h"
+#include "socket.h"
+#include "buffers.h"
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/socket.h>
+
+// Na macOS zamiast MSG_NOSIGNAL jest opcja gniazda SO_NOSIGPIPE (ustawiana w Socket).
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace bee {
+
+    FrameReader::~FrameReader() {
+        BufferPool::self().give(body_);
+    }
+
+    bool FrameReader::begin() {
+        if (size_ > Socket::maxFrame())
+            return false;
+        header_ = false;
+        have_ = 0;
+        // Duży bufor poprzedniej ramki wraca do puli, zamiast zostać z połączeniem.
+        BufferPool::self().trim(body_);
+        BufferPool::self().resize(body_, size_ + 1);
+        body_[size_] = 0;
+        return true;
+    }
+
+    Result<Option<Span<u8>>,Errc> FrameReader::read(int const fd) noexcept {
+        while (true) {
+            auto const ptr = header_
+                ? reinterpret_cast<u8*>(&size_) + have_
+                : body_.data() + have_;
+            auto const nleft = (header_ ? sizeof(size_) : size_) - have_;
+
+            if (nleft > 0) {
+                auto const nread = ::read(fd, ptr, nleft);
+                if (nread < 0) {
+                    if (errno == EINTR)
+                        continue;
+                    if (errno == EAGAIN || errno == EWOULDBLOCK)
+                        return Option<Span<u8>>{};
+                    return Failure(Errc{errno});
+                }
+                if (nread == 0)
+                    return Failure(std::errc::broken_pipe);
+                have_ += nread;
+                if (static_cast<size_t>(nread) < nleft)
+                    continue;
+            }
+
+            // Mamy kompletny nagłówek - przechodzimy do danych.
+            if (header_) {
+                if (not begin())
+                    return Failure(std::errc::message_size);
+                continue;
+            }
+
+            // Mamy kompletną ramkę.
+            return take();
+        }
+    }
+
+    Result<Option<Span<u8>>,Errc> FrameReader::consume(Span<const u8>& data) noexcept {
+        while (not data.empty()) {
+            auto const want = header_ ? sizeof(size_) : size_;
+            auto const ptr = header_
+                ? reinterpret_cast<u8*>(&size_) + have_
+                : body_.data() + have_;
+            auto const n = std::min(want - have_, data.size());
+
+            std::memcpy(ptr, data.data(), n);
+            data = data.subspan(n);
+            have_ += n;
+            if (have_ < want)
+                break;
+
+            if (header_) {
+                if (not begin())
+                    return Failure(std::errc::message_size);
+                if (size_ > 0)
+                    continue;
+            }
+            return take();
+        }
+        return Option<Span<u8>>{};
+    }
+
+    void FrameWriter::push(Span<const u8> const frame) {
+        // Bufor zwalniamy dopiero, gdy wszystko z niego zostało wysłane.
+        if (empty()) {
+            buffer_.clear();
+            sent_ = 0;
+        }
+        buffer_.insert(buffer_.end(), frame.begin(), frame.end());
+    }
+
+    Option<Errc> FrameWriter::flush(int const fd) noexcept {
+        while (sent_ < buffer_.size()) {
+            auto const nwritten = ::send(fd, buffer_.data() + sent_, buffer_.size() - sent_, MSG_NOSIGNAL);
+            if (nwritten < 0) {
+                if (errno == EINTR)
+                    continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                    return {};
+                return Errc{errno};
+            }
+            sent_ += nwritten;
+        }
+        buffer_.clear();
+        sent_ = 0;
+        return {};
+    }
+}
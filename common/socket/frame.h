@@ -0,0 +1,98 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "../../shared4cx/types.h"
+#include <system_error>
+
+namespace bee {
+
+    /*------- FrameReader:
+    Składanie ramek (rozmiar + dane) z fragmentów odczytanych
+    z gniazda nieblokującego. Ramka ma taki sam format jak
+    w Socket::writePackage.
+    -------------------------------------------------------------------*/
+    class FrameReader final {
+        size_t size_{};         // rozmiar danych z nagłówka
+        size_t have_{};         // ile bajtów bieżącej części już mamy
+        bool header_{true};     // czy czytamy jeszcze nagłówek
+        Vector<u8> body_{};     // bufor ramki, używany ponownie dla kolejnych ramek
+    public:
+        FrameReader() = default;
+        ~FrameReader();
+        FrameReader(FrameReader const&) = delete;
+        FrameReader& operator=(FrameReader const&) = delete;
+
+        /// Odczyt dostępnych danych z gniazda.
+        /// \param fd Deskryptor gniazda nieblokującego.
+        /// \return Kompletna ramka, nic (gniazdo nie ma więcej danych) lub błąd
+        ///         (std::errc::message_size - ramka większa niż Socket::maxFrame).
+        /// \remark Ramka jest w buforze czytnika - ważna do następnego wywołania read/consume.
+        ///         Za nią jest jeden dodatkowy bajt zerowy.
+        [[nodiscard]] Result<Option<Span<u8>>,Errc> read(int fd) noexcept;
+
+        /// Pobranie bajtów odebranych w inny sposób (np. io_uring).
+        /// \param data Odebrane bajty, po wywołaniu zawiera to, co nie zostało zużyte.
+        /// \return Kompletna ramka (jak w read), nic (potrzeba więcej danych) lub błąd.
+        [[nodiscard]] Result<Option<Span<u8>>,Errc> consume(Span<const u8>& data) noexcept;
+
+    private:
+        void reset() noexcept {
+            size_ = have_ = 0;
+            header_ = true;
+        }
+        /// Początek danych ramki - bufor z puli BufferPool, używany ponownie.
+        /// \return false - ramka jest za duża.
+        [[nodiscard]] bool begin();
+        Span<u8> take() noexcept {
+            auto const frame = Span{body_}.first(size_);
+            reset();
+            return frame;
+        }
+    };
+
+    /*------- FrameWriter:
+    Bufor ramek oczekujących na wysłanie przez gniazdo nieblokujące.
+    -------------------------------------------------------------------*/
+    class FrameWriter final {
+        Vector<u8> buffer_{};
+        size_t sent_{};
+    public:
+        /// Dodanie ramki do wysłania.
+        /// \param frame Kompletna ramka (z nagłówkiem, np. z Connector::pack).
+        void push(Span<const u8> frame);
+
+        /// Wysłanie tyle, ile gniazdo przyjmie.
+        /// \return Błąd lub nic (także wtedy, gdy część danych czeka na dalsze wysłanie).
+        [[nodiscard]] Option<Errc> flush(int fd) noexcept;
+
+        [[nodiscard]] bool empty() const noexcept { return sent_ == buffer_.size(); }
+        /// Liczba bajtów czekających na wysłanie.
+        [[nodiscard]] size_t size() const noexcept { return buffer_.size() - sent_; }
+    };
+}
@@ -27,21 +27,144 @@
 /*------- include files:
 -------------------------------------------------------------------*/
 #include "logger.h"
-#include <print>
-#include <iostream>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+
+namespace bee {
+
+    Logger::Logger() {
+        worker_ = std::jthread{[this](std::stop_token const& token) { loop(token); }};
+    }
+
+    Logger::~Logger() {
+        worker_.request_stop();
+        if (worker_.joinable())
+            worker_.join();
+        closed_.store(true, std::memory_order_relaxed);
+    }
+
+    Option<Level> Logger::parse(StringView const name) noexcept {
+        if (name == "error") return Level::Error;
+        if (name == "warning") return Level::Warning;
+        if (name == "info") return Level::Info;
+        if (name == "debug") return Level::Debug;
+        if (name == "trace") return Level::Trace;
+        if (name == "off") return Level::Off;
+        return {};
+    }
+
+    void Logger::flush() noexcept {
+        drain();
+    }
+
+    /// Bufor bieżącego wątku (tworzony przy pierwszym komunikacie wątku).
+    Logger::Ring* Logger::ring() noexcept {
+        struct Producer {
+            std::shared_ptr<Ring> ring{};
+            ~Producer() {
+                // Bufor zostaje u loggera, aż wypisze jego komunikaty.
+                if (ring)
+                    ring->closed.store(true, std::memory_order_release);
+            }
+        };
+        thread_local Producer producer{};
+
+        if (not producer.ring) {
+            try {
+                auto ring = std::make_shared<Ring>();
+                std::lock_guard lock{mutex_};
+                rings_.push_back(ring);
+                producer.ring = std::move(ring);
+            }
+            catch (...) {
+                return nullptr;
+            }
+        }
+        return producer.ring.get();
+    }
+
+    /// Wypisanie komunikatów ze wszystkich buforów (wywołuje wątek loggera lub flush).
+    void Logger::drain() noexcept {
+        std::lock_guard drain_lock{drain_mutex_};
+        try {
+            Vector<std::shared_ptr<Ring>> rings{};
+            {
+                std::lock_guard lock{mutex_};
+                rings = rings_;
+            }
+
+            entries_.clear();
+            for (auto const& ring : rings) {
+                // Po zamknięciu wątek nic już nie dopisze - bufor jest pusty po tym odczycie.
+                auto const closed = ring->closed.load(std::memory_order_acquire);
+                auto head = ring->head.load(std::memory_order_relaxed);
+                auto const tail = ring->tail.load(std::memory_order_acquire);
+                for (; head != tail; ++head) {
+                    auto& slot = ring->slots[head % Ring::Capacity];
+                    Entry entry{.time = slot.time, .level = slot.level, .text = {}};
+                    slot.format(slot, entry.text);
+                    entries_.push_back(std::move(entry));
+                }
+                ring->head.store(head, std::memory_order_release);
+
+                if (auto const n = ring->dropped.exchange(0, std::memory_order_relaxed))
+                    entries_.push_back(Entry{Clock::now(), Level::Warning, std::format("-- {} log messages dropped", n)});
+                if (closed) {
+                    std::lock_guard lock{mutex_};
+                    std::erase(rings_, ring);
+                }
+            }
+            if (entries_.empty())
+                return;
+
+            // Komunikaty różnych wątków w kolejności ich zgłoszenia.
+            std::ranges::stable_sort(entries_, {}, &Entry::time);
+            String out{};
+            String err{};
+            for (auto const& entry : entries_) {
+                auto& text = (entry.level >= Level::Warning) ? err : out;
+                text += entry.text;
+                text += '\n';
+            }
+            if (not out.empty()) {
+                std::fwrite(out.data(), 1, out.size(), stdout);
+                std::fflush(stdout);
+            }
+            if (not err.empty()) {
+                std::fwrite(err.data(), 1, err.size(), stderr);
+                std::fflush(stderr);
+            }
+        }
+        catch (...) {}
+    }
+
+    void Logger::loop(std::stop_token const& token) noexcept {
+        std::mutex mutex{};
+        std::condition_variable_any cv{};
+        std::unique_lock lock{mutex};
+        while (not token.stop_requested()) {
+            drain();
+            cv.wait_for(lock, token, Interval, [] { return false; });
+        }
+        drain();
+    }
+}
 
 void print_error(int errcode, std::string_view const title) noexcept {
     print_error(static_cast<std::errc>(errcode), title);
 }
 
 void print_error(std::errc const errc, std::string_view const title) noexcept {
+    using bee::Logger;
+
     // Przerwanie operacji blokującej.
     if (errc == std::errc::interrupted)
         return;
 
     // Druga strona połączenia zamknęła je.
     if (errc == std::errc::broken_pipe) {
-        std::cout << "-- Closed peer connection.\n" << std::flush;
+        Logger::info("-- Closed peer connection.");
         return;
     }
 
@@ -49,10 +172,11 @@ void print_error(std::errc const errc, std::string_view const title) noexcept {
         return;
 
     // Rzeczywiście jakiś błąd.
-    auto message = std::string{title};
-    if (not message.empty())
-        message += ": ";
-
-    message += std::make_error_code(errc).message();
-    std::println(std::cerr, "** {}\n", message);
+    if (not Logger::enabled(bee::Level::Error))
+        return;
+    auto const message = std::make_error_code(errc).message();
+    if (title.empty())
+        Logger::error("** {}", message);
+    else
+        Logger::error("** {}: {}", title, message);
 }
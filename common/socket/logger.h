@@ -27,10 +27,189 @@
 
 /*------- include files:
 -------------------------------------------------------------------*/
+#include "../../shared4cx/types.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <format>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
 #include <string_view>
 #include <system_error>
+#include <thread>
+#include <tuple>
+#include <type_traits>
 
+namespace bee {
 
+    /// Poziomy komunikatów - wypisywane są tylko te, które nie są niższe niż Logger::level().
+    enum class Level : u8 { Trace, Debug, Info, Warning, Error, Off };
+
+    /*------- Logger:
+    Komunikaty programu wypisywane przez wątek w tle.
+    Wątek, który zgłasza komunikat, tylko kopiuje jego argumenty do
+    własnego bufora cyklicznego (bez blokad i bez formatowania).
+    Formatuje je i wypisuje wątek loggera (co Interval i w flush()),
+    komunikaty wszystkich wątków w kolejności ich zgłoszenia.
+    Gdy bufor wątku jest pełny, komunikat jest pomijany (liczba pominiętych
+    jest potem wypisywana) - zgłaszający nigdy nie czeka.
+    -------------------------------------------------------------------*/
+    class Logger final {
+        using Clock = std::chrono::steady_clock;
+
+        // Komunikat: argumenty (albo gotowy tekst) i funkcja, która je formatuje i usuwa.
+        struct Slot {
+            static constexpr size_t Size = 192;
+            void (*format)(Slot& slot, String& out) noexcept;
+            Level level;
+            Clock::time_point time;
+            alignas(std::max_align_t) std::byte storage[Size];
+        };
+
+        // Bufor jednego wątku - pisze do niego tylko ten wątek, czyta tylko wątek loggera.
+        struct Ring {
+            static constexpr size_t Capacity = 1024;
+            alignas(64) std::atomic<size_t> head{};     // następny komunikat do wypisania
+            alignas(64) std::atomic<size_t> tail{};     // miejsce na następny komunikat
+            std::atomic<size_t> dropped{};
+            std::atomic_bool closed{};                  // wątek bufora już nie działa
+            std::array<Slot, Capacity> slots{};
+        };
+
+        struct Entry {
+            Clock::time_point time;
+            Level level;
+            String text;
+        };
+
+        // Teksty kopiowane są zawsze - formatowanie następuje, gdy mogą już nie istnieć.
+        template<typename T>
+        using Captured = std::conditional_t<std::is_convertible_v<T, StringView>, String, std::decay_t<T>>;
+
+        static inline std::atomic_bool closed_{};
+        std::atomic<Level> level_{Level::Info};
+        std::mutex mutex_{};
+        Vector<std::shared_ptr<Ring>> rings_{};
+        std::mutex drain_mutex_{};
+        Vector<Entry> entries_{};
+        std::jthread worker_{};
+
+        Logger();
+    public:
+        /// Jak często wątek loggera wypisuje komunikaty.
+        static constexpr std::chrono::milliseconds Interval{10};
+
+        Logger(Logger const&) = delete;
+        Logger& operator=(Logger const&) = delete;
+        Logger(Logger&&) = delete;
+        Logger& operator=(Logger&&) = delete;
+        /// Wypisanie wszystkich zgłoszonych komunikatów i zakończenie wątku.
+        ~Logger();
+
+        static Logger& self() noexcept {
+            static Logger logger{};
+            return logger;
+        }
+
+        void level(Level const level) noexcept { level_.store(level, std::memory_order_relaxed); }
+        [[nodiscard]] Level level() const noexcept { return level_.load(std::memory_order_relaxed); }
+
+        /// Czy komunikaty z tego poziomu są wypisywane (np. by nie przygotowywać argumentów).
+        [[nodiscard]] static bool enabled(Level const level) noexcept {
+            return not closed_.load(std::memory_order_relaxed) and level >= self().level();
+        }
+
+        /// Poziom z nazwy (error, warning, info, debug, trace, off).
+        static Option<Level> parse(StringView name) noexcept;
+
+        /// Wypisanie od razu wszystkich zgłoszonych komunikatów.
+        void flush() noexcept;
+
+        /// Zgłoszenie komunikatu. Argumenty są kopiowane, formatowane są później.
+        template<typename... Args>
+        static void log(Level const level, std::format_string<Args...> const fmt, Args&&... args) noexcept {
+            if (enabled(level))
+                self().push(level, fmt, std::forward<Args>(args)...);
+        }
+
+        template<typename... Args>
+        static void error(std::format_string<Args...> const fmt, Args&&... args) noexcept {
+            log(Level::Error, fmt, std::forward<Args>(args)...);
+        }
+        template<typename... Args>
+        static void warning(std::format_string<Args...> const fmt, Args&&... args) noexcept {
+            log(Level::Warning, fmt, std::forward<Args>(args)...);
+        }
+        template<typename... Args>
+        static void info(std::format_string<Args...> const fmt, Args&&... args) noexcept {
+            log(Level::Info, fmt, std::forward<Args>(args)...);
+        }
+        template<typename... Args>
+        static void debug(std::format_string<Args...> const fmt, Args&&... args) noexcept {
+            log(Level::Debug, fmt, std::forward<Args>(args)...);
+        }
+        template<typename... Args>
+        static void trace(std::format_string<Args...> const fmt, Args&&... args) noexcept {
+            log(Level::Trace, fmt, std::forward<Args>(args)...);
+        }
+
+    private:
+        template<typename... Args>
+        void push(Level const level, std::format_string<Args...> const fmt, Args&&... args) noexcept {
+            auto const ring = this->ring();
+            if (not ring)
+                return;
+            auto const tail = ring->tail.load(std::memory_order_relaxed);
+            if (tail - ring->head.load(std::memory_order_acquire) == Ring::Capacity) {
+                ring->dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            auto& slot = ring->slots[tail % Ring::Capacity];
+            using Record = std::tuple<StringView, Captured<Args>...>;
+            try {
+                if constexpr (sizeof(Record) <= Slot::Size and alignof(Record) <= alignof(std::max_align_t)) {
+                    new (slot.storage) Record{fmt.get(), std::forward<Args>(args)...};
+                    slot.format = [](Slot& slot, String& out) noexcept {
+                        auto& record = *std::launder(reinterpret_cast<Record*>(slot.storage));
+                        try {
+                            std::apply([&out](StringView const text, auto&... values) {
+                                std::vformat_to(std::back_inserter(out), text, std::make_format_args(values...));
+                            }, record);
+                        }
+                        catch (...) {}
+                        record.~Record();
+                    };
+                }
+                else {
+                    // Argumenty nie mieszczą się w komunikacie - formatowane są od razu.
+                    new (slot.storage) String{std::format(fmt, std::forward<Args>(args)...)};
+                    slot.format = [](Slot& slot, String& out) noexcept {
+                        auto& text = *std::launder(reinterpret_cast<String*>(slot.storage));
+                        try {
+                            out += text;
+                        }
+                        catch (...) {}
+                        text.~String();
+                    };
+                }
+            }
+            catch (...) {
+                return;
+            }
+            slot.level = level;
+            slot.time = Clock::now();
+            ring->tail.store(tail + 1, std::memory_order_release);
+        }
+
+        Ring* ring() noexcept;
+        void drain() noexcept;
+        void loop(std::stop_token const& token) noexcept;
+    };
+}
 
 void print_error(int errcode, std::string_view title = {}) noexcept;
 void print_error(std::errc errc, std::string_view title = {}) noexcept;
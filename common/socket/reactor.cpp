@@ -0,0 +1,165 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "reactor.h"
+
+#if defined(__linux__)
+
+#include "logger.h"
+#include <cerrno>
+#include <unistd.h>
+#include <sys/epoll.h>
+
+namespace bee {
+
+    Reactor::Reactor(MessageHandler handler) noexcept : handler_{std::move(handler)} {
+        epfd_ = epoll_create1(EPOLL_CLOEXEC);
+        if (epfd_ == INVALID_SOCKET)
+            print_error(errno, "epoll_create1");
+    }
+
+    Reactor::~Reactor() {
+        sessions_.clear();
+        if (epfd_ != INVALID_SOCKET)
+            ::close(epfd_);
+    }
+
+    Option<Errc> Reactor::add(int const fd) noexcept {
+        auto session = std::make_unique<Session>(fd);
+        if (epfd_ == INVALID_SOCKET)
+            return std::errc::bad_file_descriptor;
+        if (auto const err = session->server.nonBlocking())
+            return err;
+
+        epoll_event event{
+            .events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET,
+            .data = {.ptr = session.get()}
+        };
+        // Blokada trzymana jest do wstawienia sesji do mapy,
+        // więc wątek reaktora nie zamknie jej wcześniej.
+        std::lock_guard lock{mutex_};
+        if (epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &event) == -1)
+            return Errc{errno};
+        sessions_.emplace(fd, std::move(session));
+        return {};
+    }
+
+    void Reactor::run(std::stop_token const& token) noexcept {
+        epoll_event events[MaxEvents];
+
+        while (not token.stop_requested()) {
+            auto const n = epoll_wait(epfd_, events, MaxEvents, WaitTimeout);
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                print_error(errno, "epoll_wait");
+                break;
+            }
+
+            for (int i = 0; i < n; ++i) {
+                auto& session = *static_cast<Session*>(events[i].data.ptr);
+                auto const flags = events[i].events;
+
+                auto ok = (flags & EPOLLERR) == 0;
+                if (ok && (flags & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)))
+                    ok = onReadable(session);
+                if (ok && (flags & EPOLLOUT))
+                    ok = onWritable(session);
+                if (not ok)
+                    close(session);
+            }
+        }
+    }
+
+    /// Odczyt wszystkiego, co jest dostępne w gnieździe (wymóg trybu edge-triggered).
+    /// Odczyt przerywany jest na czas wysyłania odpowiedzi - dalsze dane czekają
+    /// w gnieździe, a onWritable wznawia go po jej wysłaniu.
+    bool Reactor::onReadable(Session& session) noexcept {
+        auto const fd = session.server.fd();
+        auto const out = [&session](Span<const u8> const bytes) {
+            session.writer.push(bytes);
+            return true;
+        };
+        while (not blocked(session)) {
+            auto frame = session.reader.read(fd);
+            if (not frame) {
+                print_error(frame.error());
+                return {};
+            }
+            if (not frame.value())
+                break;
+            if (auto const err = session.server.process(*frame.value(), handler_, out)) {
+                print_error(err.value());
+                return {};
+            }
+            if (not pump(session))
+                return {};
+        }
+        return pump(session);
+    }
+
+    bool Reactor::onWritable(Session& session) noexcept {
+        if (not pump(session))
+            return {};
+        // Po wysłaniu odpowiedzi czekające komunikaty nie dadzą już nowego zdarzenia.
+        return blocked(session) or onReadable(session);
+    }
+
+    /// Wysyłanie ramek i pobieranie kolejnych części odpowiedzi,
+    /// dopóki gniazdo przyjmuje dane.
+    bool Reactor::pump(Session& session) noexcept {
+        auto const fd = session.server.fd();
+        auto const out = [&session](Span<const u8> const bytes) {
+            session.writer.push(bytes);
+            return true;
+        };
+        while (true) {
+            if (auto const err = session.writer.flush(fd)) {
+                print_error(err.value());
+                return {};
+            }
+            if (not session.server.replying() or session.writer.size() >= HighWater)
+                return true;
+            if (auto const err = session.server.pull(out)) {
+                print_error(err.value());
+                return {};
+            }
+        }
+    }
+
+    void Reactor::close(Session const& session) noexcept {
+        auto const fd = session.server.fd();
+        Logger::info("Client disconnected ({})", session.server.peerAddress());
+
+        epoll_ctl(epfd_, EPOLL_CTL_DEL, fd, nullptr);
+        std::lock_guard lock{mutex_};
+        sessions_.erase(fd);
+    }
+}
+
+#endif
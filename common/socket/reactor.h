@@ -0,0 +1,97 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "connector.h"
+#include "frame.h"
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <unordered_map>
+
+#if defined(__linux__)
+
+namespace bee {
+
+    /*------- Reactor:
+    Pętla zdarzeń epoll (edge-triggered) obsługująca wiele połączeń
+    w jednym wątku. Gniazda są nieblokujące, ramki składane są
+    z fragmentów przez FrameReader, a kompletne (po odszyfrowaniu)
+    przekazywane do funkcji obsługi.
+    Kolejna część odpowiedzi (Server::pull) powstaje dopiero wtedy, gdy
+    w buforze wysyłania zostało mniej niż HighWater bajtów (reszta czeka
+    na EPOLLOUT). Następny komunikat połączenia czytany jest po pobraniu
+    całej odpowiedzi na poprzedni.
+    -------------------------------------------------------------------*/
+    class Reactor final {
+    public:
+        explicit Reactor(MessageHandler handler) noexcept;
+        ~Reactor();
+
+        Reactor(Reactor const&) = delete;
+        Reactor& operator=(Reactor const&) = delete;
+        Reactor(Reactor&&) = delete;
+        Reactor& operator=(Reactor&&) = delete;
+
+        /// Przejęcie połączenia (można wołać z dowolnego wątku).
+        /// \param fd Deskryptor zaakceptowanego gniazda, reaktor staje się jego właścicielem.
+        /// \return Błąd lub nic.
+        [[nodiscard]] Option<Errc> add(int fd) noexcept;
+
+        /// Pętla zdarzeń, działa do czasu zatrzymania tokenem.
+        void run(std::stop_token const& token) noexcept;
+
+    private:
+        static constexpr int MaxEvents = 64;
+        static constexpr int WaitTimeout = 250; // ms
+        /// Najwięcej bajtów czekających na wysłanie, przy których powstaje kolejna część odpowiedzi.
+        static constexpr size_t HighWater = 64 * 1024;
+
+        struct Session {
+            Server server;
+            FrameReader reader{};
+            FrameWriter writer{};
+            explicit Session(int const fd) : server{fd} {}
+        };
+
+        int epfd_{INVALID_SOCKET};
+        MessageHandler handler_;
+        std::mutex mutex_{};
+        std::unordered_map<int, std::unique_ptr<Session>> sessions_{};
+
+        bool onReadable(Session& session) noexcept;
+        bool onWritable(Session& session) noexcept;
+        bool pump(Session& session) noexcept;
+        static bool blocked(Session const& session) noexcept {
+            return session.server.replying() or session.writer.size() >= HighWater;
+        }
+        void close(Session const& session) noexcept;
+    };
+}
+
+#endif
@@ -0,0 +1,91 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "../crypto/crypto.h"
+#include "compress.h"
+#include <algorithm>
+
+namespace bee {
+
+    /// Format serializacji żądań i odpowiedzi.
+    enum class Format : u8 {
+        Json,       // tekst - czytelny przy śledzeniu komunikatów
+        Beve,       // binarny format glaze (wektory bajtów bez zamiany na liczby dziesiętne)
+    };
+
+    /// Kolejność obsługi żądań jednego połączenia.
+    enum class Dispatch : u8 {
+        Ordered,    // po kolei, odpowiedzi w kolejności żądań
+        Concurrent, // żądania wykonywane równolegle, odpowiedź wysyłana zaraz po wykonaniu (klient dopasowuje po id)
+    };
+
+    /*------- SessionOptions:
+    Ustawienia sesji uzgadniane w init().
+    Klient wysyła swoje propozycje razem z kluczem AES (zaszyfrowane RSA),
+    serwer odpowiada tym, co przyjął (zaszyfrowane już kluczem AES).
+    Kolejne ustawienia dopisujemy na końcu - krótsze propozycje
+    (starsi klienci) dostają wartości domyślne.
+    -------------------------------------------------------------------*/
+    struct SessionOptions final {
+        crypto::Auth auth{crypto::Auth::Signed};
+        Format format{Format::Json};
+        Dispatch dispatch{Dispatch::Ordered};
+        Compression compression{Compression::None};
+
+        bool operator==(SessionOptions const&) const = default;
+
+        [[nodiscard]] Vector<u8> encode() const {
+            return {static_cast<u8>(auth), static_cast<u8>(format), static_cast<u8>(dispatch), static_cast<u8>(compression)};
+        }
+
+        static SessionOptions decode(Span<const u8> const bytes) noexcept {
+            SessionOptions opt{};
+            if (bytes.size() > 0 && bytes[0] <= static_cast<u8>(crypto::Auth::Aead))
+                opt.auth = static_cast<crypto::Auth>(bytes[0]);
+            if (bytes.size() > 1 && bytes[1] <= static_cast<u8>(Format::Beve))
+                opt.format = static_cast<Format>(bytes[1]);
+            if (bytes.size() > 2 && bytes[2] <= static_cast<u8>(Dispatch::Concurrent))
+                opt.dispatch = static_cast<Dispatch>(bytes[2]);
+            if (bytes.size() > 3 && bytes[3] <= static_cast<u8>(Compression::Zstd))
+                opt.compression = static_cast<Compression>(bytes[3]);
+            return opt;
+        }
+
+        /// Ustawienia przyjęte przez serwer: propozycja klienta ograniczona do tego, na co serwer pozwala.
+        [[nodiscard]] SessionOptions accept(SessionOptions const& requested) const noexcept {
+            return SessionOptions{
+                .auth = std::min(requested.auth, auth),
+                // Każda ze stron może wymusić JSON (np. do śledzenia komunikatów).
+                .format = std::min(requested.format, format),
+                .dispatch = std::min(requested.dispatch, dispatch),
+                .compression = std::min(requested.compression, compression),
+            };
+        }
+    };
+}
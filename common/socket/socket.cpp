@@ -27,14 +27,26 @@
 /*------- include files:
 -------------------------------------------------------------------*/
 #include "socket.h"
+#include "buffers.h"
 #include "logger.h"
 #include <cerrno>
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <netdb.h>
+#include <fcntl.h>
 #include <format>
 #include <print>
 
+/*------- local constants:
+-------------------------------------------------------------------*/
+#ifdef MSG_NOSIGNAL
+// Zapis do zerwanego połączenia kończy się błędem EPIPE zamiast sygnału SIGPIPE.
+static constexpr int SendFlags = MSG_NOSIGNAL;
+#else
+// macOS - SO_NOSIGPIPE (gniazda tworzone przez Socket), serwer ignoruje też SIGPIPE.
+static constexpr int SendFlags = 0;
+#endif
+
 namespace bee {
 
     Socket::Socket() {
@@ -42,7 +54,9 @@ namespace bee {
             fd_ = fd;
             auto const ok = set(fd, SO_REUSEADDR, 1)
                 && set(fd, SO_KEEPALIVE, 1)
+#ifdef SO_NOSIGPIPE
                 && set(fd, SO_NOSIGPIPE, 1)
+#endif
                 && set(fd, SO_REUSEPORT, 1);
             ok ? fd_ = fd : ::close(fd);
         }
@@ -87,7 +101,7 @@ namespace bee {
     }
 
     Option<Errc> Socket::listen(int const backlog) const noexcept {
-        if (::listen(fd_, 5) == 0)
+        if (::listen(fd_, backlog) == 0)
             return {};
 
         return Errc{errno};
@@ -119,6 +133,17 @@ namespace bee {
         return {};
     }
 
+    Option<Errc> Socket::nonBlocking(bool const enable) const noexcept {
+        auto flags = fcntl(fd_, F_GETFL, 0);
+        if (flags == -1)
+            return Errc{errno};
+
+        flags = enable ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+        if (fcntl(fd_, F_SETFL, flags) == -1)
+            return Errc{errno};
+        return {};
+    }
+
     /********************************************************************
      *                                                                  *
      *                  W R I T E   T O   S O C K E T                   *
@@ -130,7 +155,7 @@ namespace bee {
         auto ptr = static_cast<char const*>(buffer);
 
         while (nleft > 0) {
-            auto nwritten = ::write(fd_, ptr, nleft);
+            auto nwritten = ::send(fd_, ptr, nleft, SendFlags);
             if (nwritten <= 0) {
                 if (errno == EINTR) {
                     nwritten = 0;
@@ -181,20 +206,138 @@ namespace bee {
     }
 
     Result<Vector<u8>,Errc> Socket::readPackage() const noexcept {
+        Vector<u8> bytes{};
+        auto const retv = readPackage(bytes);
+        if (not retv)
+            return Failure(retv.error());
+        bytes.resize(retv->size());
+        return bytes;
+    }
+
+    Result<Span<u8>,Errc> Socket::readPackage(Vector<u8>& buffer) const noexcept {
         size_t nbytes{};
         auto retv = readBytes(&nbytes, sizeof(nbytes));
         if (not retv)
             return Failure(retv.error());
         if (retv.value() == 0)
             return Failure(std::errc::broken_pipe);
+        if (nbytes > max_frame_)
+            return Failure(std::errc::message_size);
+        arrived_ = std::chrono::steady_clock::now();
 
-        Vector<u8> bytes(nbytes);
-        retv = readBytes(bytes.data(), nbytes);
+        // Bajt zerowy za danymi pozwala parsować tekst wprost z bufora.
+        BufferPool::self().resize(buffer, nbytes + 1);
+        buffer[nbytes] = 0;
+        retv = readBytes(buffer.data(), nbytes);
         if (not retv)
             return Failure(retv.error());
         if (retv.value() == 0)
             return Failure(std::errc::broken_pipe);
 
-        return bytes;
+        return Span{buffer}.first(nbytes);
+    }
+
+    /********************************************************************
+     *                                                                  *
+     *                      K O R U T Y N Y                             *
+     *                                                                  *
+     ********************************************************************/
+
+    Task<Result<int,Errc>> Socket::asyncAccept(EventLoop& loop) const noexcept {
+        while (true) {
+            if (auto const fd = ::accept(fd_, nullptr, nullptr); fd != INVALID_SOCKET)
+                co_return fd;
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                co_return Failure(Errc{errno});
+            if (auto const err = co_await loop.readable(fd_))
+                co_return Failure(err.value());
+        }
+    }
+
+    Task<Result<size_t,Errc>> Socket::asyncWriteBytes(EventLoop& loop, void const* const buffer, size_t const size) const noexcept {
+        auto nleft = size;
+        auto ptr = static_cast<char const*>(buffer);
+
+        while (nleft > 0) {
+            auto const nwritten = ::send(fd_, ptr, nleft, SendFlags);
+            if (nwritten < 0) {
+                if (errno == EINTR)
+                    continue;
+                if (errno != EAGAIN && errno != EWOULDBLOCK)
+                    co_return Failure(Errc{errno});
+                // Bufor gniazda jest pełny - czekamy, aż coś z niego wyjdzie.
+                if (auto const err = co_await loop.writable(fd_))
+                    co_return Failure(err.value());
+                continue;
+            }
+            nleft -= nwritten;
+            ptr += nwritten;
+        }
+        co_return size;
+    }
+
+    Task<Result<size_t,Errc>> Socket::asyncWritePackage(EventLoop& loop, Span<const u8> const bytes) const noexcept {
+        size_t const size = bytes.size();
+        if (auto const retv = co_await asyncWriteBytes(loop, &size, sizeof(size)); !retv)
+            co_return retv;
+
+        co_return co_await asyncWriteBytes(loop, bytes.data(), size);
+    }
+
+    Task<Result<size_t,Errc>> Socket::asyncReadBytes(EventLoop& loop, void* const buffer, size_t const size) const noexcept {
+        auto nleft = size;
+        auto ptr = static_cast<char*>(buffer);
+
+        while (nleft > 0) {
+            auto const nread = ::read(fd_, ptr, nleft);
+            if (nread < 0) {
+                if (errno == EINTR)
+                    continue;
+                if (errno != EAGAIN && errno != EWOULDBLOCK)
+                    co_return Failure(Errc{errno});
+                // Nie ma jeszcze danych - czekamy na nie w pętli zdarzeń.
+                if (auto const err = co_await loop.readable(fd_))
+                    co_return Failure(err.value());
+                continue;
+            }
+            if (nread == 0)
+                break;
+            nleft -= nread;
+            ptr += nread;
+        }
+        co_return size - nleft;
+    }
+
+    Task<Result<Vector<u8>,Errc>> Socket::asyncReadPackage(EventLoop& loop) const noexcept {
+        Vector<u8> bytes{};
+        auto const retv = co_await asyncReadPackage(loop, bytes);
+        if (not retv)
+            co_return Failure(retv.error());
+        bytes.resize(retv->size());
+        co_return std::move(bytes);
+    }
+
+    Task<Result<Span<u8>,Errc>> Socket::asyncReadPackage(EventLoop& loop, Vector<u8>& buffer) const noexcept {
+        size_t nbytes{};
+        auto retv = co_await asyncReadBytes(loop, &nbytes, sizeof(nbytes));
+        if (not retv)
+            co_return Failure(retv.error());
+        if (retv.value() == 0)
+            co_return Failure(std::errc::broken_pipe);
+        if (nbytes > max_frame_)
+            co_return Failure(std::errc::message_size);
+        arrived_ = std::chrono::steady_clock::now();
+
+        BufferPool::self().resize(buffer, nbytes + 1);
+        buffer[nbytes] = 0;
+        retv = co_await asyncReadBytes(loop, buffer.data(), nbytes);
+        if (not retv)
+            co_return Failure(retv.error());
+        if (retv.value() == 0)
+            co_return Failure(std::errc::broken_pipe);
+
+        co_return Span{buffer}.first(nbytes);
     }
-}
\ No newline at end of file
+}
@@ -28,17 +28,23 @@
 /*------- include files:
 -------------------------------------------------------------------*/
 #include "../../shared4cx/types.h"
+#include "coro.h"
+#include <chrono>
 #include <sys/socket.h>
 #include <system_error>
 #include <ranges>
 
 namespace bee {
     static constexpr int INVALID_SOCKET = -1;
+    /// Domyślny największy rozmiar ramki (i komunikatu po dekompresji).
+    static constexpr size_t DEFAULT_MAX_FRAME = 64 * 1024 * 1024;
 
     /*------- Socket class:
      -------------------------------------------------------------------*/
     class Socket {
         int fd_ { INVALID_SOCKET };
+        static inline size_t max_frame_{DEFAULT_MAX_FRAME};
+        mutable std::chrono::steady_clock::time_point arrived_{};
     public:
         Socket();
         explicit Socket(int const fd) : fd_(fd) {}
@@ -51,6 +57,11 @@ namespace bee {
 
         bool destroy() noexcept;
         [[nodiscard]] int fd() const noexcept { return fd_; }
+
+        /// Największa ramka przyjmowana od partnera - ramka z większym rozmiarem
+        /// w nagłówku jest odrzucana (std::errc::message_size) przed alokacją pamięci.
+        static void maxFrame(size_t const size) noexcept { max_frame_ = size; }
+        [[nodiscard]] static size_t maxFrame() noexcept { return max_frame_; }
         [[nodiscard]] Option<std::errc> connect(String const& address, int port) const noexcept;
         [[nodiscard]] Option<std::errc> bind(int port) const noexcept;
         [[nodiscard]] Option<std::errc> listen(int backlog = SOMAXCONN) const noexcept;
@@ -58,6 +69,9 @@ namespace bee {
         [[nodiscard]] String hostAddress() const noexcept;
         [[nodiscard]] String peerAddress() const noexcept;
 
+        /// Przełączenie gniazda w tryb nieblokujący (lub z powrotem w blokujący).
+        [[nodiscard]] Option<std::errc> nonBlocking(bool enable = true) const noexcept;
+
         Result<size_t, Errc> writeBytes(void const* buffer, size_t size) const noexcept;
         [[nodiscard]] Result<size_t,Errc> writePackage(Span<u8> bytes) const noexcept;
         [[nodiscard]] Result<size_t,Errc> writeText(StringView const text) const noexcept {
@@ -67,12 +81,29 @@ namespace bee {
 
         Result<size_t, Errc> readBytes(void* buffer, size_t size) const noexcept;
         [[nodiscard]] Result<Vector<u8>,Errc> readPackage() const noexcept;
+        /// Odczyt ramki do bufora używanego ponownie (bez alokacji, gdy bufor jest wystarczająco duży).
+        /// Za danymi bufor ma jeden dodatkowy bajt zerowy.
+        /// \return Dane ramki w buforze - ważne do następnego odczytu do tego bufora.
+        [[nodiscard]] Result<Span<u8>,Errc> readPackage(Vector<u8>& buffer) const noexcept;
+        /// Kiedy odczytany został nagłówek ostatniej ramki (readPackage) - bez czasu czekania na nią.
+        [[nodiscard]] std::chrono::steady_clock::time_point arrived() const noexcept { return arrived_; }
         [[nodiscard]] Result<String,Errc> readText() const noexcept {
             return readPackage().transform([](auto&& vec) {
                 return std::string{vec.begin(), vec.end()};
             });
         }
 
+        /************************************************************
+         *  Wersje dla korutyn (gniazdo musi być nieblokujące).     *
+         ************************************************************/
+
+        [[nodiscard]] Task<Result<int,Errc>> asyncAccept(EventLoop& loop) const noexcept;
+        [[nodiscard]] Task<Result<size_t,Errc>> asyncWriteBytes(EventLoop& loop, void const* buffer, size_t size) const noexcept;
+        [[nodiscard]] Task<Result<size_t,Errc>> asyncWritePackage(EventLoop& loop, Span<const u8> bytes) const noexcept;
+        [[nodiscard]] Task<Result<size_t,Errc>> asyncReadBytes(EventLoop& loop, void* buffer, size_t size) const noexcept;
+        [[nodiscard]] Task<Result<Vector<u8>,Errc>> asyncReadPackage(EventLoop& loop) const noexcept;
+        [[nodiscard]] Task<Result<Span<u8>,Errc>> asyncReadPackage(EventLoop& loop, Vector<u8>& buffer) const noexcept;
+
     private:
         static bool set(int const fd, int const option, int const flag) noexcept {
             return setsockopt(fd, SOL_SOCKET, option, &flag, sizeof(int)) != -1;
@@ -0,0 +1,296 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "uring.h"
+
+#if defined(BEE_WITH_URING)
+
+#include "logger.h"
+#include <cerrno>
+#include <unistd.h>
+#include <sys/socket.h>
+
+namespace bee {
+
+    Uring::Uring(MessageHandler handler) noexcept : handler_{std::move(handler)} {}
+
+    Uring::~Uring() {
+        connections_.clear();
+        if (ready_)
+            io_uring_queue_exit(&ring_);
+    }
+
+    Option<Errc> Uring::init(unsigned const entries) noexcept {
+        if (auto const ret = io_uring_queue_init(entries, &ring_, 0); ret < 0)
+            return Errc{-ret};
+        ready_ = true;
+
+        // Każde połączenie ma swój stały bufor odczytu, zarejestrowany w jądrze
+        // (jądro nie musi go mapować przy każdej operacji).
+        buffers_.resize(MaxConnections * BufferSize);
+        Vector<iovec> iovecs(MaxConnections);
+        for (size_t i = 0; i < MaxConnections; ++i)
+            iovecs[i] = iovec{.iov_base = buffer(i), .iov_len = BufferSize};
+        if (auto const ret = io_uring_register_buffers(&ring_, iovecs.data(), iovecs.size()); ret < 0)
+            return Errc{-ret};
+
+        connections_.resize(MaxConnections);
+        free_.reserve(MaxConnections);
+        for (size_t i = MaxConnections; i > 0; --i)
+            free_.push_back(i - 1);
+        return {};
+    }
+
+    Option<Errc> Uring::run(int const listenFd, std::atomic_bool const& running) noexcept {
+        listenFd_ = listenFd;
+        submitAccept();
+
+        while (running and not stopped_ and not failed_) {
+            __kernel_timespec timeout{.tv_sec = 0, .tv_nsec = 250'000'000};
+            io_uring_cqe* cqe{};
+            if (auto const ret = io_uring_submit_and_wait_timeout(&ring_, &cqe, 1, &timeout, nullptr);
+                ret < 0 && ret != -ETIME && ret != -EINTR) {
+                print_error(-ret, "io_uring_submit_and_wait_timeout");
+                break;
+            }
+
+            unsigned head{};
+            unsigned count{};
+            io_uring_for_each_cqe(&ring_, head, cqe) {
+                ++count;
+                auto const data = io_uring_cqe_get_data64(cqe);
+                auto const slot = static_cast<size_t>(data >> 8);
+                switch (static_cast<Op>(data & 0xff)) {
+                    case Accept: onAccept(cqe->res, cqe->flags); break;
+                    case Read: onRead(slot, cqe->res); break;
+                    case Write: onWrite(slot, cqe->res); break;
+                    case Retry: submitAccept(); break;
+                }
+            }
+            io_uring_cq_advance(&ring_, count);
+        }
+        return failed_;
+    }
+
+    io_uring_sqe* Uring::sqe() noexcept {
+        auto entry = io_uring_get_sqe(&ring_);
+        if (not entry) {
+            // Kolejka zgłoszeń jest pełna - przekazujemy ją do jądra.
+            io_uring_submit(&ring_);
+            entry = io_uring_get_sqe(&ring_);
+        }
+        return entry;
+    }
+
+    void Uring::submitAccept() noexcept {
+        auto const entry = sqe();
+        io_uring_prep_multishot_accept(entry, listenFd_, nullptr, nullptr, 0);
+        io_uring_sqe_set_data64(entry, tag(Accept, 0));
+    }
+
+    /// Ponowienie accept po czasie AcceptRetry (zgłoszenie timeout, po nim submitAccept).
+    void Uring::submitRetry() noexcept {
+        auto const entry = sqe();
+        io_uring_prep_timeout(entry, &retry_, 0, 0);
+        io_uring_sqe_set_data64(entry, tag(Retry, 0));
+    }
+
+    void Uring::submitRead(size_t const slot) noexcept {
+        auto& conn = *connections_[slot];
+        auto const entry = sqe();
+        io_uring_prep_read_fixed(entry, conn.server.fd(), buffer(slot), BufferSize, 0, static_cast<int>(slot));
+        io_uring_sqe_set_data64(entry, tag(Read, slot));
+        ++conn.inflight;
+    }
+
+    /// Wysłanie bloku ramek (albo jego niewysłanej reszty).
+    /// Naraz w toku jest tylko jedno zgłoszenie zapisu, co zachowuje kolejność ramek.
+    void Uring::submitWrite(size_t const slot) noexcept {
+        auto& conn = *connections_[slot];
+        if (conn.writing or conn.closing)
+            return;
+
+        if (conn.sent == conn.sending.size()) {
+            if (conn.pending.empty())
+                return;
+            std::swap(conn.sending, conn.pending);
+            conn.pending.clear();
+            conn.sent = 0;
+        }
+
+        auto const entry = sqe();
+        io_uring_prep_send(entry, conn.server.fd(), conn.sending.data() + conn.sent, conn.sending.size() - conn.sent, MSG_NOSIGNAL);
+        io_uring_sqe_set_data64(entry, tag(Write, slot));
+        conn.writing = true;
+    }
+
+    void Uring::onAccept(int const res, unsigned const flags) noexcept {
+        // Multishot accept trzeba zgłosić ponownie, jeśli jądro je zakończyło.
+        auto const more = (flags & IORING_CQE_F_MORE) != 0;
+
+        if (res < 0) {
+            print_error(-res, "accept");
+            switch (-res) {
+                case EINVAL:
+                    // Jądro bez multishot accept (lub gniazdo nie nasłuchuje) - ponowienie nic nie da.
+                    failed_ = Errc{-res};
+                    break;
+                case EMFILE:
+                case ENFILE:
+                case ENOBUFS:
+                case ENOMEM:
+                    // Ponowienie od razu tylko powtórzyłoby błąd - czekamy, aż zwolnią się zasoby.
+                    if (not more)
+                        submitRetry();
+                    break;
+                default:
+                    // Błąd dotyczy jednego połączenia (np. ECONNABORTED).
+                    if (not more)
+                        submitAccept();
+            }
+            return;
+        }
+        if (not more)
+            submitAccept();
+        if (free_.empty()) {
+            Logger::error("Too many connections");
+            ::close(res);
+            return;
+        }
+
+        auto const slot = free_.back();
+        free_.pop_back();
+        connections_[slot] = std::make_unique<Connection>(res);
+        submitRead(slot);
+    }
+
+    void Uring::onRead(size_t const slot, int const res) noexcept {
+        auto& conn = *connections_[slot];
+        --conn.inflight;
+
+        if (conn.closing or res <= 0) {
+            if (res < 0)
+                print_error(-res);
+            close(slot);
+            return;
+        }
+
+        conn.unread = Span<const u8>{buffer(slot), static_cast<size_t>(res)};
+        consume(slot);
+    }
+
+    /// Składanie ramek z odebranych danych i ich obsługa. W czasie wysyłania
+    /// odpowiedzi reszta danych zostaje w buforze (onWrite wznawia obsługę),
+    /// bufor jest zwalniany do kolejnego odczytu dopiero po zużyciu całości.
+    void Uring::consume(size_t const slot) noexcept {
+        auto& conn = *connections_[slot];
+        auto const out = [&conn](Span<const u8> const bytes) {
+            conn.pending.insert(conn.pending.end(), bytes.begin(), bytes.end());
+            return true;
+        };
+        while (not conn.blocked() and not conn.unread.empty()) {
+            auto frame = conn.reader.consume(conn.unread);
+            if (not frame) {
+                print_error(frame.error());
+                close(slot);
+                return;
+            }
+            if (not frame.value())
+                break;
+            if (auto const err = conn.server.process(*frame.value(), handler_, out)) {
+                print_error(err.value());
+                close(slot);
+                return;
+            }
+            if (not pull(slot))
+                return;
+        }
+
+        submitWrite(slot);
+        if (conn.unread.empty() and conn.inflight == 0)
+            submitRead(slot);
+    }
+
+    /// Pobieranie kolejnych części odpowiedzi, dopóki na wysłanie czeka mniej niż HighWater.
+    bool Uring::pull(size_t const slot) noexcept {
+        auto& conn = *connections_[slot];
+        auto const out = [&conn](Span<const u8> const bytes) {
+            conn.pending.insert(conn.pending.end(), bytes.begin(), bytes.end());
+            return true;
+        };
+        while (conn.server.replying() and conn.queued() < HighWater) {
+            if (auto const err = conn.server.pull(out)) {
+                print_error(err.value());
+                close(slot);
+                return {};
+            }
+        }
+        return true;
+    }
+
+    void Uring::onWrite(size_t const slot, int const res) noexcept {
+        auto& conn = *connections_[slot];
+        conn.writing = false;
+
+        if (res < 0) {
+            print_error(-res);
+            close(slot);
+            return;
+        }
+        if (conn.closing) {
+            close(slot);
+            return;
+        }
+        // Gniazdo mogło przyjąć tylko część danych - resztę wyślemy w kolejnym zgłoszeniu.
+        conn.sent += res;
+        if (not pull(slot))
+            return;
+        submitWrite(slot);
+        // Po wysłaniu odpowiedzi - obsługa komunikatów, które na nią czekały.
+        if (not conn.blocked())
+            consume(slot);
+    }
+
+    /// Zamknięcie połączenia. Miejsce (i bufor) jest zwalniane dopiero,
+    /// gdy jądro zakończy wszystkie operacje dotyczące połączenia.
+    void Uring::close(size_t const slot) noexcept {
+        auto& conn = *connections_[slot];
+        if (not conn.closing) {
+            Logger::info("Client disconnected ({})", conn.server.peerAddress());
+            conn.closing = true;
+            ::shutdown(conn.server.fd(), SHUT_RDWR);
+        }
+        if (conn.inflight > 0 or conn.writing)
+            return;
+
+        connections_[slot].reset();
+        free_.push_back(slot);
+    }
+}
+
+#endif
@@ -0,0 +1,132 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "connector.h"
+#include "frame.h"
+#include <atomic>
+#include <memory>
+
+#if defined(BEE_WITH_URING)
+#include <liburing.h>
+
+namespace bee {
+
+    /*------- Uring:
+    Obsługa połączeń przez io_uring (Linux, liburing).
+    - połączenia przyjmowane są jednym zgłoszeniem multishot accept
+      (po braku deskryptorów zgłaszanym ponownie z opóźnieniem),
+    - odczyt odbywa się do zarejestrowanych buforów (read_fixed),
+      ramki składane są przez FrameReader,
+    - ramki (nagłówek i dane w jednym bloku) wysyłane są jednym zgłoszeniem,
+      ramki powstałe w czasie wysyłania łączone są w kolejny blok,
+    - kolejna część odpowiedzi (Server::pull) powstaje dopiero wtedy, gdy na
+      wysłanie czeka mniej niż HighWater bajtów; do tego czasu następne
+      komunikaty czekają w buforze odczytu (nowy odczyt nie jest zgłaszany).
+    Każdy wątek ma własny obiekt Uring (własne kolejki).
+    -------------------------------------------------------------------*/
+    class Uring final {
+    public:
+        explicit Uring(MessageHandler handler) noexcept;
+        ~Uring();
+
+        Uring(Uring const&) = delete;
+        Uring& operator=(Uring const&) = delete;
+        Uring(Uring&&) = delete;
+        Uring& operator=(Uring&&) = delete;
+
+        /// Utworzenie kolejek i rejestracja buforów.
+        /// \return Błąd (np. jądro bez io_uring) lub nic.
+        [[nodiscard]] Option<Errc> init(unsigned entries = 256) noexcept;
+
+        /// Pętla obsługi połączeń przyjmowanych z gniazda nasłuchującego.
+        /// Działa do wyzerowania running lub wywołania stop().
+        /// \return Błąd, jeśli jądro nie obsługuje przyjmowania połączeń
+        /// (multishot accept) - wtedy trzeba użyć innego transportu.
+        [[nodiscard]] Option<Errc> run(int listenFd, std::atomic_bool const& running) noexcept;
+        void stop() noexcept { stopped_ = true; }
+
+    private:
+        static constexpr size_t MaxConnections = 256;
+        static constexpr size_t BufferSize = 16 * 1024;
+        /// Najwięcej bajtów czekających na wysłanie, przy których powstaje kolejna część odpowiedzi.
+        static constexpr size_t HighWater = 64 * 1024;
+        /// Po ilu nanosekundach ponowić accept, gdy zabrakło deskryptorów (EMFILE, ENFILE).
+        static constexpr long long AcceptRetry = 100'000'000;
+
+        enum Op : u64 { Accept, Read, Write, Retry };
+
+        struct Connection {
+            Server server;
+            FrameReader reader{};
+            Vector<u8> sending{};   // blok w trakcie wysyłania (nie może się zmieniać)
+            Vector<u8> pending{};   // ramki czekające na następne wysłanie
+            size_t sent{};          // ile bajtów bloku sending już wysłano
+            Span<const u8> unread{}; // odebrane dane (w buforze połączenia) jeszcze nie złożone w ramki
+            bool writing{};         // czy zgłoszenie zapisu jest w toku
+            int inflight{};         // liczba zgłoszeń odczytu w toku
+            bool closing{};
+            explicit Connection(int const fd) : server{fd} {}
+
+            [[nodiscard]] size_t queued() const noexcept { return sending.size() - sent + pending.size(); }
+            [[nodiscard]] bool blocked() const noexcept { return server.replying() or queued() >= HighWater; }
+        };
+
+        io_uring ring_{};
+        bool ready_{};
+        int listenFd_{INVALID_SOCKET};
+        __kernel_timespec retry_{.tv_sec = 0, .tv_nsec = AcceptRetry};  // musi istnieć do końca zgłoszenia
+        Option<Errc> failed_{};
+        std::atomic_bool stopped_{};
+        MessageHandler handler_;
+        Vector<u8> buffers_{};
+        Vector<std::unique_ptr<Connection>> connections_{};
+        Vector<size_t> free_{};
+
+        static u64 tag(Op const op, size_t const slot) noexcept {
+            return (static_cast<u64>(slot) << 8) | op;
+        }
+        u8* buffer(size_t const slot) noexcept {
+            return buffers_.data() + slot * BufferSize;
+        }
+
+        io_uring_sqe* sqe() noexcept;
+        void submitAccept() noexcept;
+        void submitRetry() noexcept;
+        void submitRead(size_t slot) noexcept;
+        void submitWrite(size_t slot) noexcept;
+        void onAccept(int res, unsigned flags) noexcept;
+        void onRead(size_t slot, int res) noexcept;
+        void consume(size_t slot) noexcept;
+        bool pull(size_t slot) noexcept;
+        void onWrite(size_t slot, int res) noexcept;
+        void close(size_t slot) noexcept;
+    };
+}
+
+#endif
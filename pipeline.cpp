@@ -0,0 +1,140 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "pipeline.h"
+#include "common/socket/connector.h"
+#include "common/socket/logger.h"
+
+namespace bee {
+
+    Pipeline::Pipeline(Connector const& conn)
+        : conn_{conn}
+        , reader_{[this](std::stop_token const& token) { loop(token); }}
+    {}
+
+    std::future<Pipeline::Answer> Pipeline::send(Request request) {
+        std::promise<Answer> promise{};
+        auto future = promise.get_future();
+        send(std::move(request), [promise = std::move(promise)](Answer&& answer) mutable {
+            promise.set_value(std::move(answer));
+        });
+        return future;
+    }
+
+    void Pipeline::send(Request request, Callback callback) {
+        // Całe wysłanie pod write_mutex_ - ramki trafiają do gniazda w kolejności numerów.
+        std::unique_lock writing{write_mutex_};
+        auto const err = [&]() -> Option<std::errc> {
+            std::lock_guard lock{mutex_};
+            if (error_)
+                return error_;
+            if (request.id == 0) {
+                while (pending_.contains(next_id_))
+                    ++next_id_;
+                request.id = next_id_++;
+            }
+            else if (pending_.contains(request.id))
+                // Odpowiedzi nie dałoby się jednoznacznie przypisać.
+                return std::errc::invalid_argument;
+            return {};
+        }();
+        if (err or not request.encode(conn_.options().format, buffer_)) {
+            writing.unlock();
+            callback(Failure(err.value_or(std::errc::bad_message)));
+            return;
+        }
+
+        // Rejestracja przed wysłaniem - odpowiedź może przyjść zanim send się zakończy.
+        {
+            std::lock_guard lock{mutex_};
+            pending_.emplace(request.id, std::move(callback));
+        }
+        cv_.notify_one();
+
+        if (auto const stat = conn_.write(buffer_); not stat) {
+            writing.unlock();
+            // Połączenie nie działa - odczyt też zakończy się błędem.
+            if (auto cb = take(request.id))
+                (*cb)(Failure(stat.error()));
+        }
+    }
+
+    void Pipeline::loop(std::stop_token const& token) noexcept {
+        while (true) {
+            {
+                // Czytamy tylko wtedy, gdy czekamy na odpowiedź (inaczej read
+                // blokowałby zakończenie). Po żądaniu zatrzymania wątek
+                // kończy się dopiero, gdy nie ma już czekających żądań.
+                std::unique_lock lock{mutex_};
+                if (not cv_.wait(lock, token, [this] { return not pending_.empty(); }))
+                    return;
+            }
+
+            auto const data = conn_.read();
+            if (not data) {
+                fail(data.error());
+                return;
+            }
+            auto response = Response::decode(conn_.options().format, data.value());
+            if (not response) {
+                fail(std::errc::bad_message);
+                return;
+            }
+            auto const id = response->id;
+            auto& collector = partial_[id];
+            if (not collector.add(std::move(response.value())))
+                continue;
+            auto answer = collector.take();
+            partial_.erase(id);
+
+            if (auto cb = take(id))
+                (*cb)(std::move(answer));
+            else
+                Logger::warning("Response with unknown id: {}", id);
+        }
+    }
+
+    Option<Pipeline::Callback> Pipeline::take(size_t const id) noexcept {
+        std::lock_guard lock{mutex_};
+        auto node = pending_.extract(id);
+        if (node.empty())
+            return {};
+        return std::move(node.mapped());
+    }
+
+    void Pipeline::fail(std::errc const err) noexcept {
+        std::unordered_map<size_t, Callback> pending{};
+        {
+            std::lock_guard lock{mutex_};
+            error_ = err;
+            pending.swap(pending_);
+        }
+        for (auto& [_, callback] : pending)
+            callback(Failure(err));
+    }
+}
@@ -0,0 +1,93 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "request.h"
+#include "response.h"
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace bee {
+
+    /*------- Pipeline:
+    Wysyłanie wielu żądań jedno za drugim, bez czekania na odpowiedzi.
+    Odpowiedzi odczytuje osobny wątek i dopasowuje je do żądań po id
+    (std::future albo funkcja zwrotna). Zapis i odczyt używają osobnych
+    części kontekstu szyfrowania połączenia, więc działają równolegle,
+    zapisy są szeregowane. W czasie życia obiektu połączenie (po init)
+    nie może być używane w inny sposób.
+    Jeśli klient zaproponował Dispatch::Concurrent, serwer wykonuje żądania
+    równolegle i odpowiedzi przychodzą w kolejności ich wykonania.
+    Odpowiedź przesłana częściami (Select) jest składana w całość.
+    -------------------------------------------------------------------*/
+    class Pipeline final {
+    public:
+        using Answer = Result<Response,std::errc>;
+        using Callback = std::move_only_function<void(Answer&&)>;
+
+        explicit Pipeline(Connector const& conn);
+        /// Czeka na odpowiedzi na wszystkie wysłane żądania.
+        ~Pipeline() = default;
+        Pipeline(Pipeline const&) = delete;
+        Pipeline& operator=(Pipeline const&) = delete;
+
+        /// Wysłanie żądania, odpowiedź przez future.
+        /// \param request Żądanie - bez id (0) dostaje kolejny wolny numer.
+        [[nodiscard]] std::future<Answer> send(Request request);
+
+        /// Wysłanie żądania, odpowiedź przekazywana funkcji.
+        /// \remark Funkcja wywoływana jest w wątku odczytu - nie powinna długo trwać.
+        void send(Request request, Callback callback);
+
+    private:
+        Connector const& conn_;
+        // Zapis: bufor serializacji używany ponownie.
+        std::mutex write_mutex_{};
+        String buffer_{};
+        // Żądania czekające na odpowiedź.
+        std::mutex mutex_{};
+        std::condition_variable_any cv_{};
+        std::unordered_map<size_t, Callback> pending_{};
+        size_t next_id_{1};
+        Option<std::errc> error_{};
+        // Odpowiedzi przychodzące częściami (Response::more) - używane tylko w wątku odczytu.
+        std::unordered_map<size_t, Collector> partial_{};
+        // Wątek odczytu musi być ostatni - kończy się jako pierwszy.
+        std::jthread reader_;
+
+        void loop(std::stop_token const& token) noexcept;
+        /// Odebranie funkcji zwrotnej żądania (nic - żądanie już obsłużone).
+        Option<Callback> take(size_t id) noexcept;
+        /// Połączenie nie działa - wszystkie czekające żądania kończą się błędem.
+        void fail(std::errc err) noexcept;
+    };
+}
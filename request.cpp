@@ -28,44 +28,96 @@
 -------------------------------------------------------------------*/
 #include "request.h"
 #include "common/socket/connector.h"
+#include "common/socket/logger.h"
 
 namespace bee {
 
     Result<Response,std::errc> Request::write(Connector const& conn) const noexcept {
-        std::println("Request::write");
-        std::println(" - request: {}", *this);
+        Logger::debug("Request::write - request: {}", *this);
 
-        if (auto json = toJSON()) {
-            // Wysłanie żądania do gniazda.
-            if (auto const stat = conn.write(std::move(json.value())); not stat)
-                return Failure(stat.error());
+        Collector collector{};
+        Option<Response> response{};
+        auto const err = stream(conn, [&collector, &response](Response&& part) {
+            if (collector.add(std::move(part)))
+                response = collector.take();
+        });
+        if (err)
+            return Failure(err.value());
+        if (not response)
+            return Failure(std::errc::bad_message);
+
+        Logger::debug("Request::write - response: {}", response.value());
+        return std::move(response.value());
+    }
+
+    Option<std::errc> Request::stream(Connector const& conn, std::function<void(Response&&)> const& part) const noexcept {
+        auto const format = conn.options().format;
+        thread_local String bytes{};
+        if (not encode(format, bytes))
+            return std::errc::bad_message;
+
+        // Wysłanie żądania do gniazda.
+        if (auto const stat = conn.write(bytes); not stat)
+            return stat.error();
 
-            // Odczyt danych odpowiedzi z gniazda.
+        // Odczyt kolejnych części odpowiedzi, aż do ostatniej.
+        while (true) {
             auto const data = conn.read();
             if (not data)
-                return Failure(data.error());
+                return data.error();
+            auto response = Response::decode(format, data.value());
+            if (not response)
+                return std::errc::bad_message;
 
-            // Z odczytanych danych tworzymy obiekt Odpowiedzi.
-            if (auto const response = Response::fromJSON(data.value())) {
-                std::println(" - response: {}", response.value());
-                return response.value();
-            }
+            auto const more = response->more;
+            part(std::move(response.value()));
+            if (not more)
+                return {};
         }
-        return Failure(std::errc::bad_message);
     }
 
     Result<Request,std::errc> Request::read(Connector const& conn) noexcept {
-        std::println("Request::read");
-
         auto const data = conn.read();
         if (not data)
             return Failure(data.error());
 
-        auto request = fromJSON(data.value());
+        auto request = decode(conn.options().format, data.value());
         if (not request)
             return Failure(std::errc::bad_message);
 
-        std::println(" - request: {}", request.value());
+        Logger::debug("Request::read - request: {}", request.value());
         return request.value();
     }
-}
\ No newline at end of file
+
+    Task<Result<Response,std::errc>> Request::asyncWrite(Connector const& conn, EventLoop& loop) const noexcept {
+        auto const format = conn.options().format;
+        if (String bytes{}; encode(format, bytes)) {
+            if (auto const stat = co_await conn.asyncWrite(loop, bytes); not stat)
+                co_return Failure(stat.error());
+
+            Collector collector{};
+            while (true) {
+                auto const data = co_await conn.asyncRead(loop);
+                if (not data)
+                    co_return Failure(data.error());
+
+                auto response = Response::decode(format, data.value());
+                if (not response)
+                    break;
+                if (collector.add(std::move(response.value())))
+                    co_return collector.take();
+            }
+        }
+        co_return Failure(std::errc::bad_message);
+    }
+
+    Task<Result<Request,std::errc>> Request::asyncRead(Connector const& conn, EventLoop& loop) noexcept {
+        auto const data = co_await conn.asyncRead(loop);
+        if (not data)
+            co_return Failure(data.error());
+
+        if (auto request = decode(conn.options().format, data.value()))
+            co_return std::move(request.value());
+        co_return Failure(std::errc::bad_message);
+    }
+}
@@ -29,7 +29,10 @@
 -------------------------------------------------------------------*/
 #include "shared4cx/types.h"
 #include "response.h"
+#include "common/socket/coro.h"
+#include "common/socket/logger.h"
 #include <format>
+#include <functional>
 #include <iostream>
 #include <glaze/glaze.hpp>
 #include <glaze/api/std/deque.hpp>
@@ -42,6 +45,8 @@ namespace bee {
         Database,
         Table,
         ExecQuery,
+        Batch,          // żądania z pola batch w jednej ramce
+        Stats,          // statystyki czasów obsługi żądań (Delete - ich wyzerowanie)
     };
     enum RequestSubType {
         None,
@@ -53,6 +58,7 @@ namespace bee {
         Select,
         Update,
         Delete,
+        Transaction,    // Batch: wszystkie żądania w jednej transakcji
     };
 
     inline std::string str(RequestType const& type) noexcept {
@@ -60,6 +66,8 @@ namespace bee {
             case Database: return "Database";
             case Table: return "Table";
             case ExecQuery: return "ExecQuery";
+            case Batch: return "Batch";
+            case Stats: return "Stats";
             default: return "Unknown";
         }
     }
@@ -73,6 +81,7 @@ namespace bee {
             case Select: return "Select";
             case Update: return "Update";
             case Delete: return "Delete";
+            case Transaction: return "Transaction";
             default: return "Unknown";
         }
     }
@@ -85,46 +94,97 @@ namespace bee {
         RequestSubType subType{};
         String value{};
         Vector<u8> content{};
+        Vector<Request> batch{};    // żądania typu Batch
 
         [[nodiscard]] Option<String> toJSON() const noexcept {
             String buffer{};
-            if (auto const ec = glz::write_json(*this, buffer)) {
-                std::println(std::cerr, "Error: {}", format_error(ec.ec));
+            if (not toJSON(buffer))
                 return {};
-            }
             return buffer;
         }
 
-        static Option<Request> fromJSON(String const& json) noexcept {
+        /// Serializacja do wskazanego bufora (można go używać ponownie, bez alokacji).
+        [[nodiscard]] bool toJSON(String& buffer) const noexcept {
+            if (auto const ec = glz::write_json(*this, buffer)) {
+                Logger::error("Error: {}", format_error(ec.ec));
+                return false;
+            }
+            return true;
+        }
+
+        /// \remark Za tekstem musi być bajt zerowy (String, tekst z Connector::read).
+        static Option<Request> fromJSON(StringView const json) noexcept {
             Request request{};
-            if (auto const ec = glz::read_json(request, json)) {
-                std::println(std::cerr, "Error: {}", format_error(ec.ec));
+            if (auto const ec = glz::read<JsonRead>(request, json)) {
+                Logger::error("Error: {}", format_error(ec.ec));
                 return {};
             }
             return request;
         }
 
+        /// Serializacja w uzgodnionym formacie (SessionOptions::format) do wskazanego bufora.
+        [[nodiscard]] bool encode(Format const format, String& buffer) const noexcept {
+            if (format == Format::Json)
+                return toJSON(buffer);
+            if (auto const ec = glz::write_beve(*this, buffer)) {
+                Logger::error("Error: {}", format_error(ec.ec));
+                return false;
+            }
+            return true;
+        }
+
+        /// Odtworzenie obiektu z bajtów w uzgodnionym formacie.
+        static Option<Request> decode(Format const format, StringView const bytes) noexcept {
+            if (format == Format::Json)
+                return fromJSON(bytes);
+            Request object{};
+            if (auto const ec = glz::read_beve(object, bytes)) {
+                Logger::error("Error: {}", format_error(ec.ec));
+                return {};
+            }
+            return object;
+        }
+
         /// Wysłanie żądania poprzez wskazane gniazdo (używane zazwyczaj po stronie klienta).
         /// \param conn Obiekt gniazda, poprzez który należy wysłać dane.
         /// \return Albo odpowiedź na żądanie lub błąd errc.
+        /// \remark Odpowiedź przesłana częściami (Select) jest składana w całość (Collector).
         [[nodiscard]] Result<Response,std::errc> write(Connector const& conn) const noexcept;
 
+        /// Wysłanie żądania i odbiór odpowiedzi częściami, bez składania całego wyniku.
+        /// \param part Funkcja wywoływana dla każdej części (ostatnia ma more == false).
+        /// \return Błąd lub nic.
+        [[nodiscard]] Option<std::errc> stream(Connector const& conn, std::function<void(Response&&)> const& part) const noexcept;
+
         /// Odczyt żądania ze wskazanego gniazda (używane zazwyczaj po stronie serwera).
         /// \param conn Obiekt gniazda, z którego należy czytać dane.
         /// \return Albo obiekt żądania lub błąd errc.
         static Result<Request,std::errc> read(Connector const& conn) noexcept;
+
+        /// Wersje write/read dla korutyn działających w pętli zdarzeń.
+        [[nodiscard]] Task<Result<Response,std::errc>> asyncWrite(Connector const& conn, EventLoop& loop) const noexcept;
+        static Task<Result<Request,std::errc>> asyncRead(Connector const& conn, EventLoop& loop) noexcept;
     };
 }
 
 template<>
 struct glz::meta<bee::Request> {
     using T = bee::Request;
+    /// Pusty batch nie jest zapisywany (tak jak w Response).
+    static constexpr bool skip_if(auto&& value, std::string_view const key, glz::meta_context const&) {
+        using V = std::decay_t<decltype(value)>;
+        if constexpr (std::same_as<V, bee::Vector<bee::Request>>)
+            return key == "batch" and value.empty();
+        else
+            return false;
+    }
     static constexpr auto value = object(
         &T::id,
         &T::type,
         &T::subType,
         &T::value,
-        &T::content
+        &T::content,
+        &T::batch
     );
 };
 
@@ -132,8 +192,8 @@ template<>
 struct std::formatter<bee::Request> : std::formatter<std::string> {
     auto format(bee::Request const& req, std::format_context& ctx) const {
         return formatter<std::string>::format(
-            std::format("Request[ id: {}, type: {} | {}, value: {}, content: {} ]",
-                req.id, str(req.type), str(req.subType), req.value, req.content),
+            std::format("Request[ id: {}, type: {} | {}, value: {}, content: {}, batch: {} ]",
+                req.id, str(req.type), str(req.subType), req.value, req.content, req.batch.size()),
             ctx);
     }
 };
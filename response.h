@@ -30,9 +30,14 @@
 #include <iostream>
 #include <glaze/glaze.hpp>
 #include "common/socket/connector.h"
+#include "common/socket/logger.h"
 #include "shared4cx/types.h"
 
 namespace bee {
+    /// Odczyt JSON pomijający nieznane klucze - partner w innej wersji
+    /// (np. bez Request::batch czy Response::more) nadal się porozumie.
+    inline constexpr glz::opts JsonRead{.error_on_unknown_keys = false};
+
     /*------- Response struct:
     -------------------------------------------------------------------*/
     struct Response final {
@@ -41,48 +46,147 @@ namespace bee {
         int value{};
         String message{};
         Vector<u8> data{};
+        Vector<Response> batch{};   // odpowiedzi na żądania z Request::batch (w tej samej kolejności)
+        bool more{};                // za tą częścią odpowiedzi (to samo id) będą następne
 
         [[nodiscard]] Option<String> toJSON() const noexcept {
             String buffer{};
-            if (auto const ec = glz::write_json(*this, buffer)) {
-                std::println(std::cerr, "Error: {}", format_error(ec.ec));
+            if (not toJSON(buffer))
                 return {};
-            }
             return buffer;
         }
 
+        /// Serializacja do wskazanego bufora (można go używać ponownie, bez alokacji).
+        [[nodiscard]] bool toJSON(String& buffer) const noexcept {
+            if (auto const ec = glz::write_json(*this, buffer)) {
+                Logger::error("Error: {}", format_error(ec.ec));
+                return false;
+            }
+            return true;
+        }
+
         /// Konstruktor obiektu z tekstu JSON.
-        static Option<Response> fromJSON(String const& json) noexcept {
+        /// \remark Za tekstem musi być bajt zerowy (String, tekst z Connector::read).
+        static Option<Response> fromJSON(StringView const json) noexcept {
             Response request{};
-            if (auto const ec = glz::read_json(request, json)) {
-                std::println(std::cerr, "Error: {}", format_error(ec.ec));
+            if (auto const ec = glz::read<JsonRead>(request, json)) {
+                Logger::error("Error: {}", format_error(ec.ec));
                 return {};
             }
             return request;
         }
 
-        /// Przesłanie zserializowanej postaci obiektu (JSON) do wskazanego gniazda.
+        /// Serializacja w uzgodnionym formacie (SessionOptions::format) do wskazanego bufora.
+        [[nodiscard]] bool encode(Format const format, String& buffer) const noexcept {
+            if (format == Format::Json)
+                return toJSON(buffer);
+            if (auto const ec = glz::write_beve(*this, buffer)) {
+                Logger::error("Error: {}", format_error(ec.ec));
+                return false;
+            }
+            return true;
+        }
+
+        /// Odtworzenie obiektu z bajtów w uzgodnionym formacie.
+        static Option<Response> decode(Format const format, StringView const bytes) noexcept {
+            if (format == Format::Json)
+                return fromJSON(bytes);
+            Response object{};
+            if (auto const ec = glz::read_beve(object, bytes)) {
+                Logger::error("Error: {}", format_error(ec.ec));
+                return {};
+            }
+            return object;
+        }
+
+        /// Przesłanie zserializowanej postaci obiektu (w uzgodnionym formacie) do wskazanego gniazda.
         /// \param conn Obiekt gniazda.
         /// \return Zwraca błąd lub nic.
         [[nodiscard]] Option<std::errc> write(Connector const& conn) const noexcept {
-            if (auto json = toJSON()) {
-                if (auto const stat = conn.write(std::move(json.value())); not stat)
+            if (auto& bytes = buffer(); encode(conn.options().format, bytes)) {
+                if (auto const stat = conn.write(bytes); not stat)
                     return stat.error();
                 return {};
             }
             return std::errc::bad_message;
         }
+
+        /// Wersja write dla korutyn działających w pętli zdarzeń.
+        [[nodiscard]] Task<Option<std::errc>> asyncWrite(Connector const& conn, EventLoop& loop) const noexcept {
+            // Bufor wątku jest zużywany (kopiowany do ramki) jeszcze przed pierwszym zawieszeniem.
+            if (auto& bytes = buffer(); encode(conn.options().format, bytes)) {
+                if (auto const stat = co_await conn.asyncWrite(loop, bytes); not stat)
+                    co_return stat.error();
+                co_return Option<std::errc>{};
+            }
+            co_return std::errc::bad_message;
+        }
+
+    private:
+        /// Bufor serializacji wątku, używany ponownie przy każdym wysłaniu.
+        static String& buffer() noexcept {
+            thread_local String buffer{};
+            return buffer;
+        }
+    };
+
+    /*------- Collector:
+    Składanie odpowiedzi przesłanej częściami (Response::more) w jedną
+    odpowiedź: części trafiają do batch, value to łączna liczba wierszy.
+    Dane części (układ Columns) nie są rozpakowywane ani kopiowane.
+    -------------------------------------------------------------------*/
+    class Collector final {
+        Option<Response> answer_{};
+    public:
+        /// Dodanie kolejnej części.
+        /// \return true - odpowiedź jest kompletna (można ją odebrać przez take).
+        bool add(Response&& part) {
+            auto const more = part.more;
+            if (not answer_ and not more) {
+                // Odpowiedź w jednej części - zostaje taka, jaka jest.
+                answer_ = std::move(part);
+                return true;
+            }
+            if (not answer_)
+                answer_ = Response{.id = part.id};
+            answer_->value += part.value;
+            if (part.code != 0) {
+                answer_->code = part.code;
+                answer_->message = part.message;
+            }
+            answer_->batch.push_back(std::move(part));
+            return not more;
+        }
+
+        [[nodiscard]] Response take() noexcept {
+            auto answer = std::move(answer_.value());
+            answer_.reset();
+            return answer;
+        }
     };
 }
 template<>
 struct glz::meta<bee::Response> {
     using T = bee::Response;
+    /// Pola dodane później zapisywane są tylko wtedy, gdy mają znaczenie
+    /// (partnerzy, którzy ich nie znają, nie dostają nieznanych kluczy).
+    static constexpr bool skip_if(auto&& value, std::string_view const key, glz::meta_context const&) {
+        using V = std::decay_t<decltype(value)>;
+        if constexpr (std::same_as<V, bool>)
+            return key == "more" and not value;
+        else if constexpr (std::same_as<V, bee::Vector<bee::Response>>)
+            return key == "batch" and value.empty();
+        else
+            return false;
+    }
     static constexpr auto value = object(
         &T::id,
         &T::code,
         &T::value,
         &T::message,
-        &T::data
+        &T::data,
+        &T::batch,
+        &T::more
     );
 };
 
@@ -90,8 +194,8 @@ template<>
 struct std::formatter<bee::Response> : std::formatter<std::string> {
     auto format(bee::Response const& ans, std::format_context& ctx) const {
         return formatter<std::string>::format(
-            std::format("Response[ id: {}, code: {}, value: {}, message: {}, content: {} ]",
-                ans.id, ans.code, ans.value, ans.message, ans.data),
+            std::format("Response[ id: {}, code: {}, value: {}, message: {}, content: {}, batch: {}, more: {} ]",
+                ans.id, ans.code, ans.value, ans.message, ans.data, ans.batch.size(), ans.more),
             ctx);
     }
 };
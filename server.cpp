@@ -27,61 +27,701 @@
 /*------- include files:
 -------------------------------------------------------------------*/
 #include "common/socket/all.hpp"
-#include <iostream>
-#include <print>
 #include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <csignal>
+#include <system_error>
+#include <unordered_set>
+#include <unistd.h>
+#include <sys/socket.h>
 #include "request.h"
 #include "server/handler.h"
+#include "server/arena.h"
+#include "server/executor.h"
+#include "server/config.h"
+#include "server/statistics.h"
+#include "shared4cx/shared.h"
+#include "common/socket/reactor.h"
+#include "common/socket/uring.h"
 
 using namespace bee;
 using namespace bee::crypto;
 
 
 std::atomic_bool running{true};
+std::atomic_int listening{-1};
 
+/// Zatrzymanie serwera (SIGINT, SIGTERM) - koniec przyjmowania połączeń.
+/// Zamknięcie gniazda nasłuchującego przerywa czekanie w accept
+/// (w dowolnym wątku i transporcie).
+extern "C" void stopServer(int) {
+    running = false;
+    if (auto const fd = listening.load(); fd >= 0)
+        ::shutdown(fd, SHUT_RDWR);
+}
+
+/*------- Connections:
+Połączenia trybu blokującego, każde we własnym wątku. Przy zatrzymaniu
+serwera ich odczyt jest przerywany (odpowiedzi w toku są jeszcze wysyłane),
+wątek główny czeka na zakończenie wszystkich - pula queries musi je przetrwać.
+-------------------------------------------------------------------*/
+class Connections final {
+    std::mutex mutex_{};
+    std::condition_variable finished_{};
+    std::unordered_set<int> fds_{};
+    size_t threads_{};
+    bool closing_{};
+public:
+    /// Wątek połączenia - rejestracja przed jego uruchomieniem i zakończenie.
+    void enter() noexcept {
+        std::lock_guard lock{mutex_};
+        ++threads_;
+    }
+    void leave() noexcept {
+        std::lock_guard lock{mutex_};
+        if (--threads_ == 0)
+            finished_.notify_all();
+    }
+
+    /// Gniazdo obsługiwanego połączenia.
+    /// \return false jeśli serwer jest już zatrzymywany.
+    bool add(int const fd) {
+        std::lock_guard lock{mutex_};
+        if (closing_)
+            return false;
+        fds_.insert(fd);
+        return true;
+    }
+    /// Wyrejestrowanie przed zamknięciem gniazda (jego numer może potem dostać inny plik).
+    void remove(int const fd) noexcept {
+        std::lock_guard lock{mutex_};
+        fds_.erase(fd);
+    }
+
+    /// Przerwanie odczytu wszystkich połączeń i czekanie na ich wątki.
+    void close() noexcept {
+        std::unique_lock lock{mutex_};
+        closing_ = true;
+        for (auto const fd : fds_)
+            ::shutdown(fd, SHUT_RD);
+        finished_.wait(lock, [this] { return threads_ == 0; });
+    }
+};
+
+
+/// Odczyt żądania z pomiarem czasów odczytu, odszyfrowania i parsowania.
+Result<Request,std::errc> readRequest(Server const& server, Sample& sample) {
+    auto const data = server.read();
+    if (not data)
+        return Failure(data.error());
+    sample.add(Phase::Read, server.timing().read);
+    sample.add(Phase::Decrypt, server.timing().decrypt);
+
+    auto request = sample.measure(Phase::Parse, [&] { return Request::decode(server.options().format, data.value()); });
+    if (not request)
+        return Failure(std::errc::bad_message);
+    Logger::debug("Received {}", request.value());
+    sample.type = request->type;
+    sample.subType = request->subType;
+    return std::move(request.value());
+}
+
+/// Wysłanie części odpowiedzi z pomiarem czasów serializacji, szyfrowania i zapisu.
+Option<std::errc> writeResponse(Server const& server, Response const& response, Sample& sample) {
+    thread_local String bytes{};
+    auto const encoded = sample.measure(Phase::Serialize, [&] { return response.encode(server.options().format, bytes); });
+    // Tymczasowe obiekty kroku obsługi, który przygotował tę część, nie są już potrzebne.
+    Arena::local().reset();
+    if (not encoded)
+        return std::errc::bad_message;
+    if (auto const stat = server.write(bytes); not stat)
+        return stat.error();
+    sample.add(Phase::Encrypt, server.timing().encrypt);
+    sample.add(Phase::Write, server.timing().write);
+    if (response.code != 0)
+        sample.failed = true;
+    return {};
+}
+
+/// Wykonanie żądania i wysłanie wszystkich części odpowiedzi.
+/// Pobranie kolejnej części (Reply::next) jest częścią wykonania żądania.
+bool serveRequest(Server const& server, Session& session, Request&& request, Sample& sample) {
+    auto reply = sample.measure(Phase::Handle, [&] { return handleRequestStream(session, std::move(request)); });
+    while (true) {
+        auto const response = sample.measure(Phase::Handle, [&] { return reply.next(); });
+        if (not response)
+            break;
+        if (auto const err = writeResponse(server, response.value(), sample)) {
+            print_error(err.value());
+            return false;
+        }
+    }
+    Statistics::self().record(sample);
+    return true;
+}
+
+/*------- Concurrent:
+Połączenie z żądaniami wykonywanymi równolegle w puli queries (Dispatch::Concurrent).
+Wątek połączenia tylko czyta żądania - nie więcej niż MaxInflight naraz
+(klient, który nie czyta odpowiedzi, nie zajmie całej puli).
+Wątki puli przygotowują (i serializują) po jednej części odpowiedzi,
+szyfruje i wysyła je osobny wątek połączenia - blokujący zapis nigdy
+nie zajmuje wątku puli. Gdy na wysłanie czeka HighWater bajtów, dalszy ciąg
+odpowiedzi jest odkładany i zlecany ponownie po opróżnieniu kolejki,
+zawsze temu samemu wątkowi puli (kursor działa na połączeniu z bazą tego wątku).
+Wolne zapytanie nie wstrzymuje szybkich - części różnych odpowiedzi
+mogą się przeplatać (klient rozróżnia je po id).
+-------------------------------------------------------------------*/
+class Concurrent final {
+    static constexpr size_t MaxInflight = 8;
+    static constexpr size_t HighWater = 64 * 1024;
+
+    /// Żądanie w toku.
+    struct Call {
+        Request request;
+        Sample sample;
+        Option<Reply> reply{};
+        size_t worker{};                    // wątek puli z kursorem odpowiedzi
+        Sample::Clock::duration encrypt{};  // czasy wątku wysyłającego
+        Sample::Clock::duration write{};
+    };
+
+    /// Część odpowiedzi czekająca na wysłanie.
+    struct Part {
+        String bytes{};
+        std::shared_ptr<Call> call{};
+        bool last{};
+    };
 
-void clientHandler(int const fd) {
+    Server const& server_;
+    Session& session_;
+    Executor& queries_;
+    std::mutex mutex_{};
+    std::condition_variable changed_{};
+    std::deque<Part> parts_{};
+    Vector<std::shared_ptr<Call>> parked_{};
+    size_t queued_{};       // bajty czekające w parts_
+    size_t inflight_{};
+    bool broken_{};         // błąd zapisu - pozostałe odpowiedzi są porzucane
+    bool closed_{};         // koniec odczytu żądań
+public:
+    Concurrent(Server const& server, Session& session, Executor& queries) noexcept
+    : server_{server}, session_{session}, queries_{queries} {}
+
+    /// Obsługa połączenia, wraca po wysłaniu (lub porzuceniu) wszystkich odpowiedzi.
+    void serve() {
+        std::jthread sender{[this] { send(); }};
+
+        while (true) {
+            {
+                std::unique_lock lock{mutex_};
+                changed_.wait(lock, [this] { return inflight_ < MaxInflight or broken_; });
+                if (broken_)
+                    break;
+            }
+            Sample sample{};
+            auto request = readRequest(server_, sample);
+            if (not request) {
+                print_error(request.error());
+                break;
+            }
+            auto call = std::make_shared<Call>(std::move(request.value()), sample);
+            {
+                std::lock_guard lock{mutex_};
+                ++inflight_;
+            }
+            if (not queries_.submit([this, call] { produce(call); })) {
+                finish();
+                break;
+            }
+        }
+
+        {
+            std::lock_guard lock{mutex_};
+            closed_ = true;
+        }
+        changed_.notify_all();
+        // Połączenie musi przetrwać wszystkie zlecone żądania - czeka na nie wątek wysyłający.
+    }
+
+private:
+    /// Przygotowanie kolejnej części odpowiedzi (w wątku puli).
+    void produce(std::shared_ptr<Call> const& call) noexcept {
+        auto& current = *call;
+        if (not current.reply) {
+            current.worker = queries_.worker().value_or(0);
+            current.reply = current.sample.measure(Phase::Handle, [&] {
+                return handleRequestStream(session_, std::move(current.request));
+            });
+        }
+        auto const response = current.sample.measure(Phase::Handle, [&] { return current.reply->next(); });
+        if (not response) {
+            current.reply.reset();
+            finish();
+            return;
+        }
+        String bytes{};
+        auto const encoded = current.sample.measure(Phase::Serialize, [&] { return response->encode(server_.options().format, bytes); });
+        // Tymczasowe obiekty kroku obsługi, który przygotował tę część, nie są już potrzebne.
+        Arena::local().reset();
+        if (not encoded) {
+            print_error(std::errc::bad_message);
+            current.reply.reset();
+            finish();
+            return;
+        }
+        if (response->code != 0)
+            current.sample.failed = true;
+        // Kursor jest zamykany w wątku, w którym został otwarty.
+        auto const last = not response->more;
+        if (last)
+            current.reply.reset();
+
+        bool resubmit{};
+        {
+            // Powiadomienie pod blokadą - po ostatniej części połączenie może zaraz przestać istnieć.
+            std::lock_guard lock{mutex_};
+            if (broken_) {
+                current.reply.reset();
+                --inflight_;
+            }
+            else {
+                queued_ += bytes.size();
+                parts_.push_back(Part{std::move(bytes), call, last});
+                if (not last) {
+                    if (queued_ < HighWater)
+                        resubmit = true;
+                    else
+                        parked_.push_back(call);
+                }
+            }
+            changed_.notify_all();
+        }
+        if (resubmit)
+            resume(call);
+    }
+
+    /// Zlecenie dalszego ciągu odpowiedzi wątkowi puli, w którym działa jej kursor.
+    void resume(std::shared_ptr<Call> const& call) noexcept {
+        if (not queries_.submit(call->worker, [this, call] { produce(call); })) {
+            call->reply.reset();
+            finish();
+        }
+    }
+
+    /// Zakończenie żądania (wysłane lub porzucone).
+    void finish() noexcept {
+        std::lock_guard lock{mutex_};
+        --inflight_;
+        changed_.notify_all();
+    }
+
+    /// Szyfrowanie i wysyłanie części odpowiedzi (wątek wysyłający połączenia).
+    /// Kończy się po zakończeniu odczytu i wszystkich żądań.
+    void send() noexcept {
+        while (true) {
+            Part part{};
+            Vector<std::shared_ptr<Call>> ready{};
+            bool broken{};
+            {
+                std::unique_lock lock{mutex_};
+                changed_.wait(lock, [this] { return not parts_.empty() or (closed_ and inflight_ == 0); });
+                if (parts_.empty())
+                    return;
+                part = std::move(parts_.front());
+                parts_.pop_front();
+                queued_ -= part.bytes.size();
+                if (queued_ < HighWater)
+                    ready.swap(parked_);
+                broken = broken_;
+            }
+            // Odłożone odpowiedzi wracają do puli także po błędzie - tam zostaną porzucone.
+            for (auto const& call : ready)
+                resume(call);
+
+            auto& call = *part.call;
+            if (not broken) {
+                if (auto const stat = server_.write(part.bytes); not stat) {
+                    print_error(stat.error());
+                    {
+                        std::lock_guard lock{mutex_};
+                        broken_ = true;
+                    }
+                    // Przerwanie odczytu - wątek połączenia nie czeka na kolejne żądania.
+                    ::shutdown(server_.fd(), SHUT_RDWR);
+                    changed_.notify_all();
+                    broken = true;
+                }
+                else {
+                    call.encrypt += server_.timing().encrypt;
+                    call.write += server_.timing().write;
+                }
+            }
+            if (part.last) {
+                // Ostatnią część wątek puli dodał do kolejki po zakończeniu pracy z próbką.
+                if (not broken) {
+                    call.sample.add(Phase::Encrypt, call.encrypt);
+                    call.sample.add(Phase::Write, call.write);
+                    Statistics::self().record(call.sample);
+                }
+                finish();
+            }
+        }
+    }
+};
+
+void clientHandler(int const fd, Executor& queries, Connections& connections) {
     Server server{fd};
-    std::println("server init");
+    if (not connections.add(fd))
+        return;
+    // Niszczony przed server - gniazdo jest wyrejestrowane, zanim zostanie zamknięte.
+    struct Registered {
+        Connections& connections;
+        int fd;
+        ~Registered() { connections.remove(fd); }
+    } const registered{connections, fd};
+    Logger::debug("server init");
     if (!server.init()) {
-        std::println(std::cerr, "Failed to initialize server socket!");
+        Logger::error("Failed to initialize server socket!");
         return;
     }
 
-    std::println("------- Client connected: {} -------", server.peerAddress());
+    Logger::info("------- Client connected: {} -------", server.peerAddress());
+
+    Session session{};
+    if (server.options().dispatch == Dispatch::Concurrent)
+        Concurrent{server, session, queries}.serve();
+    else {
+        while (true) {
+            Sample sample{};
+            auto request = readRequest(server, sample);
+            if (!request) {
+                print_error(request.error());
+                break;
+            }
+            if (not serveRequest(server, session, std::move(request.value()), sample))
+                break;
+        }
+    }
+
+    Logger::info("Client disconnected ({})", server.peerAddress());
+}
+
+/// Odpowiedź w toku w trybach nieblokujących (pobierana częściami przez transport).
+struct Streaming {
+    Reply reply;
+    Sample sample;
+    Format format;
+};
+
+/// Obsługa odszyfrowanego żądania w trybach nieblokujących.
+/// Sesja połączenia przechowywana jest w jego kontekście (Server::context).
+/// Ramki czyta i wysyła pętla zdarzeń, mierzone są tylko parsowanie, wykonanie,
+/// serializacja i (w respond) szyfrowanie.
+/// Kolejną część wyniku (porcję kursora) transport pobiera dopiero wtedy,
+/// gdy poprzednie zostały wysłane - wynik nie jest buforowany w całości.
+Option<NextPart> handleMessage(StringView const bytes, Format const format, std::any& context) {
+    Sample sample{};
+    auto request = sample.measure(Phase::Parse, [&] { return Request::decode(format, bytes); });
+    if (not request)
+        return {};
+    sample.type = request->type;
+    sample.subType = request->subType;
+    if (not context.has_value())
+        context = std::make_shared<Session>();
+    auto& session = *std::any_cast<std::shared_ptr<Session>&>(context);
+    auto reply = sample.measure(Phase::Handle, [&] { return handleRequestStream(session, std::move(request.value())); });
+
+    auto const state = std::make_shared<Streaming>(std::move(reply), sample, format);
+    return NextPart{[state](Respond const& respond) -> Option<bool> {
+        thread_local String answer{};
+        auto& current = *state;
+        auto const response = current.sample.measure(Phase::Handle, [&] { return current.reply.next(); });
+        if (not response) {
+            Statistics::self().record(current.sample);
+            return false;
+        }
+        auto const encoded = current.sample.measure(Phase::Serialize, [&] { return response->encode(current.format, answer); });
+        Arena::local().reset();
+        if (not encoded)
+            return {};
+        if (not current.sample.measure(Phase::Encrypt, [&] { return respond(answer); }))
+            return {};
+        if (response->code != 0)
+            current.sample.failed = true;
+        if (response->more)
+            return true;
+        Statistics::self().record(current.sample);
+        return false;
+    }};
+}
+
+size_t threadsCount(Config const& config) noexcept {
+    return config.workers ? config.workers : std::max(1u, std::thread::hardware_concurrency());
+}
 
+#if defined(__linux__)
+/// Obsługa połączeń w pętlach zdarzeń epoll.
+/// Każda pętla działa we własnym wątku i obsługuje wiele połączeń.
+void serveReactor(Server const& server, Config const& config) {
+    auto const n = threadsCount(config);
+    Vector<std::unique_ptr<Reactor>> reactors{};
+    Vector<std::jthread> threads{};
+    for (size_t i = 0; i < n; ++i) {
+        auto& reactor = *reactors.emplace_back(std::make_unique<Reactor>(handleMessage));
+        threads.emplace_back([&reactor](std::stop_token const& token) {
+            Pool::eventLoopThread(true);
+            reactor.run(token);
+        });
+    }
+    Logger::info("Server waiting for connection ({}), reactors: {}", server.hostAddress(), n);
+
+    size_t next{};
+    while (running) {
+        if (auto const fd = server.accept()) {
+            if (auto const err = reactors[next++ % n]->add(fd.value()))
+                print_error(err.value());
+        }
+    }
+}
+#endif
+
+/// Wersja readRequest dla korutyn.
+Task<Result<Request,std::errc>> asyncReadRequest(Server const& server, EventLoop& loop, Sample& sample) {
+    auto const data = co_await server.asyncRead(loop);
+    if (not data)
+        co_return Failure(data.error());
+    sample.add(Phase::Read, server.timing().read);
+    sample.add(Phase::Decrypt, server.timing().decrypt);
+
+    auto request = sample.measure(Phase::Parse, [&] { return Request::decode(server.options().format, data.value()); });
+    if (not request)
+        co_return Failure(std::errc::bad_message);
+    Logger::debug("Received {}", request.value());
+    sample.type = request->type;
+    sample.subType = request->subType;
+    co_return std::move(request.value());
+}
+
+/// Wersja writeResponse dla korutyn.
+Task<Option<std::errc>> asyncWriteResponse(Server const& server, EventLoop& loop, Response const& response, Sample& sample) {
+    // Bufor wątku jest zużywany (kopiowany do ramki) jeszcze przed pierwszym zawieszeniem.
+    thread_local String bytes{};
+    auto const encoded = sample.measure(Phase::Serialize, [&] { return response.encode(server.options().format, bytes); });
+    // Arena wątku jest wspólna dla korutyn pętli - zwalniana przed zawieszeniem.
+    Arena::local().reset();
+    if (not encoded)
+        co_return std::errc::bad_message;
+    if (auto const stat = co_await server.asyncWrite(loop, bytes); not stat)
+        co_return stat.error();
+    sample.add(Phase::Encrypt, server.timing().encrypt);
+    sample.add(Phase::Write, server.timing().write);
+    if (response.code != 0)
+        sample.failed = true;
+    co_return Option<std::errc>{};
+}
+
+/// Obsługa połączenia w korutynie (odpowiednik clientHandler).
+Task<> clientSession(EventLoop& loop, int const fd) {
+    Server server{fd};
+    if (auto const err = server.nonBlocking()) {
+        print_error(err.value());
+        co_return;
+    }
+    if (not co_await server.asyncInit(loop)) {
+        Logger::error("Failed to initialize server socket!");
+        co_return;
+    }
+    Logger::info("------- Client connected: {} -------", server.peerAddress());
+
+    Session session{};
     while (true) {
-        auto request = Request::read(server);
-        if (!request) {
+        Sample sample{};
+        auto request = co_await asyncReadRequest(server, loop, sample);
+        if (not request) {
             print_error(request.error());
             break;
         }
-        auto response = handleRequest(std::move(request.value()));
-        if (auto const err = response.write(server)) {
+        // Kolejna część wyniku jest czytana dopiero po wysłaniu poprzedniej.
+        auto reply = sample.measure(Phase::Handle, [&] { return handleRequestStream(session, std::move(request.value())); });
+        Option<std::errc> err{};
+        while (not err) {
+            auto const response = sample.measure(Phase::Handle, [&] { return reply.next(); });
+            if (not response)
+                break;
+            err = co_await asyncWriteResponse(server, loop, response.value(), sample);
+        }
+        if (err) {
             print_error(err.value());
             break;
         }
+        Statistics::self().record(sample);
+    }
+    Logger::info("Client disconnected ({})", server.peerAddress());
+}
+
+/// Przyjmowanie połączeń w korutynie. Wszystkie pętle czekają na tym samym
+/// (nieblokującym) gnieździe, połączenie trafia do pętli, która pierwsza je przyjmie.
+Task<> acceptSessions(EventLoop& loop, Server const& server) {
+    while (running) {
+        if (auto const fd = co_await server.asyncAccept(loop))
+            spawn(loop, clientSession(loop, fd.value()));
+        else
+            print_error(fd.error());
+    }
+    loop.stop();
+}
+
+/// Obsługa połączeń przez korutyny, po jednej pętli zdarzeń na wątek.
+void serveCoroutines(Server const& server, Config const& config) {
+    if (auto const err = server.nonBlocking()) {
+        print_error(err.value());
+        return;
+    }
+    auto const n = threadsCount(config);
+    Logger::info("Server waiting for connection ({}), event loops: {}", server.hostAddress(), n);
+
+    auto const serve = [&server](std::stop_token const& token) {
+        Pool::eventLoopThread(true);
+        EventLoop loop{};
+        spawn(loop, acceptSessions(loop, server));
+        loop.run(token);
+    };
+    // Ostatnia pętla działa w wątku głównym - funkcja wraca dopiero po jej
+    // zakończeniu, pozostałe pętle zatrzymują (i czekają na nie) destruktory jthread.
+    Vector<std::jthread> threads{};
+    for (size_t i = 1; i < n; ++i)
+        threads.emplace_back(serve);
+    serve({});
+}
+
+#if defined(BEE_WITH_URING)
+/// Obsługa połączeń przez io_uring, każdy wątek ma własne kolejki
+/// i własne zgłoszenie multishot accept na wspólnym gnieździe nasłuchującym.
+/// \return false jeśli io_uring (lub multishot accept) nie jest dostępne
+/// (wtedy używamy trybu blokującego).
+bool serveUring(Server const& server, Config const& config) {
+    auto const n = threadsCount(config);
+    Vector<std::unique_ptr<Uring>> rings{};
+    for (size_t i = 0; i < n; ++i) {
+        auto& ring = *rings.emplace_back(std::make_unique<Uring>(handleMessage));
+        if (auto const err = ring.init()) {
+            print_error(err.value(), "io_uring");
+            return {};
+        }
     }
+    Logger::info("Server waiting for connection ({}), io_uring threads: {}", server.hostAddress(), n);
 
-    std::println("Client disconnected ({})", server.peerAddress());
+    // Pierwszy wątek, któremu jądro odmówi przyjmowania połączeń, zatrzymuje wszystkie.
+    std::atomic_bool unsupported{};
+    {
+        Vector<std::jthread> threads{};
+        for (auto& ring : rings)
+            threads.emplace_back([&ring, &rings, &unsupported, fd = server.fd()] {
+                Pool::eventLoopThread(true);
+                if (auto const err = ring->run(fd, running)) {
+                    print_error(err.value(), "io_uring accept");
+                    unsupported = true;
+                    for (auto& other : rings)
+                        other->stop();
+                }
+            });
+    }
+    return not unsupported;
 }
+#endif
+
+int main(int const argc, char* argv[]) {
+    auto config = Config::fromArgs(argc, argv);
+    Logger::self().level(config.logLevel);
+    // Klient zrywający połączenie w czasie odpowiedzi nie może zakończyć serwera.
+    std::signal(SIGPIPE, SIG_IGN);
+
+    // Stały klucz serwera - wczytany raz przy starcie, zamiast generowania przy każdym połączeniu.
+    if (config.identity.empty()) {
+        if (auto const home = homeDirectory()) {
+            auto const path = std::format("{}/.beesoft_test", home.value());
+            if (not createDirectory(path))
+                config.identity = std::format("{}/server_key.pem", path);
+        }
+    }
+    if (config.identity.empty() or not KeyPool::self().loadIdentity(config.identity))
+        Logger::warning("Server key not loaded, using a temporary one.");
+
+    SessionOptions policy{.auth = Auth::Aead, .format = Format::Beve, .dispatch = Dispatch::Concurrent, .compression = SupportedCompression};
+    if (config.signedOnly)
+        policy.auth = Auth::Signed;
+    if (config.jsonOnly)
+        policy.format = Format::Json;
+    if (config.ordered)
+        policy.dispatch = Dispatch::Ordered;
+    if (config.uncompressed)
+        policy.compression = Compression::None;
+    Server::policy(policy);
+    if (config.maxFrame)
+        Socket::maxFrame(config.maxFrame);
+    Pool::relaxedSync(config.relaxedSync);
 
-int main() {
     Server const server{};
 
-    if (auto const err = server.run(123456)) {
+    if (auto const err = server.run(config.port)) {
         print_error(err.value());
         exit(EXIT_FAILURE);
     }
+    listening = server.fd();
+    std::signal(SIGINT, stopServer);
+    std::signal(SIGTERM, stopServer);
+
+#if defined(__linux__)
+    if (config.transport == Transport::Epoll) {
+        serveReactor(server, config);
+        return EXIT_SUCCESS;
+    }
+#endif
+    if (config.transport == Transport::Coroutine) {
+        serveCoroutines(server, config);
+        return EXIT_SUCCESS;
+    }
+#if defined(BEE_WITH_URING)
+    if (config.transport == Transport::Uring) {
+        if (serveUring(server, config))
+            return EXIT_SUCCESS;
+        Logger::info("io_uring is not available, falling back to blocking transport");
+    }
+#endif
 
-    std::println("Server waiting for connection ({})", server.hostAddress());
+    // Każde połączenie ma własny wątek - przez cały czas połączenia czeka on
+    // na dane, więc w puli wątków zajmowałby miejsce innych połączeń
+    // (liczba jednoczesnych klientów byłaby ograniczona liczbą wątków puli).
+    // Wątek główny zajmuje się tylko przyjmowaniem połączeń.
+    // Pula queries wykonuje krótkie zadania - żądania połączeń z Dispatch::Concurrent.
+    Executor queries{config.workers};
+    Logger::info("Server waiting for connection ({}), query workers: {}", server.hostAddress(), queries.size());
 
+    Connections connections{};
     while (running) {
-        std::println("Waiting for connection...");
+        Logger::debug("Waiting for connection...");
         if (auto const fd = server.accept()) {
-            clientHandler(fd.value());
+            connections.enter();
+            try {
+                std::thread{[fd = fd.value(), &queries, &connections] {
+                    clientHandler(fd, queries, connections);
+                    connections.leave();
+                }}.detach();
+            }
+            catch (std::system_error const& e) {
+                Logger::error("Failed to start connection thread: {}", e.what());
+                ::close(fd.value());
+                connections.leave();
+            }
         }
     }
 
+    Logger::info("Server is stopping, waiting for connections to finish");
+    connections.close();
     return EXIT_SUCCESS;
 }
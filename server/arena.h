@@ -0,0 +1,81 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "../shared4cx/types.h"
+#include <memory_resource>
+
+namespace bee {
+
+    /*------- Arena:
+    Pamięć obiektów tymczasowych żądania (porcja wyniku Select, zestawienie
+    Stats). Przydział to tylko przesunięcie wskaźnika, zwolnienie
+    pojedynczego obiektu nic nie robi - całość zwalniana jest naraz
+    przez reset (lub w destruktorze).
+    Bloki arena bierze z puli swojego wątku i do niej je oddaje, więc
+    kolejne żądania korzystają z tych samych bloków, bez malloc/free
+    i bez blokad wspólnych dla wszystkich wątków.
+    \remark Arena należy do jednego wątku (tworzona, używana i usuwana w nim).
+    -------------------------------------------------------------------*/
+    class Arena final {
+        std::pmr::monotonic_buffer_resource resource_;
+    public:
+        /// Rozmiar pierwszego bloku (kolejne są coraz większe).
+        static constexpr size_t InitialSize = 16 * 1024;
+        /// Największy blok przechowywany w puli (większe idą prosto do systemu).
+        static constexpr size_t LargestBlock = 4 * 1024 * 1024;
+
+        Arena() noexcept : resource_{InitialSize, blocks()} {}
+        ~Arena() = default;
+        Arena(Arena const&) = delete;
+        Arena& operator=(Arena const&) = delete;
+
+        /// Arena żądania obsługiwanego w bieżącym wątku. Obiekty z niej nie mogą
+        /// przetrwać kroku obsługi (handleRequest, Reply::next), transport zwalnia
+        /// ją po serializacji każdej części odpowiedzi.
+        static Arena& local() noexcept {
+            thread_local Arena arena{};
+            return arena;
+        }
+
+        [[nodiscard]] std::pmr::memory_resource* resource() noexcept { return &resource_; }
+
+        /// Zwolnienie wszystkiego, co zostało przydzielone z areny (bloki wracają do puli).
+        /// \remark Obiekty korzystające z areny muszą być już usunięte.
+        void reset() noexcept { resource_.release(); }
+
+    private:
+        /// Pula bloków aren bieżącego wątku.
+        static std::pmr::memory_resource* blocks() noexcept {
+            thread_local std::pmr::unsynchronized_pool_resource pool{
+                std::pmr::pool_options{.max_blocks_per_chunk = 0, .largest_required_pool_block = LargestBlock}
+            };
+            return &pool;
+        }
+    };
+}
@@ -0,0 +1,115 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "../shared4cx/types.h"
+#include "../common/socket/logger.h"
+#include <charconv>
+#include <string_view>
+
+namespace bee {
+
+    /// Sposób obsługi połączeń.
+    enum class Transport {
+        Blocking,   // własny wątek na każde połączenie, blokujące read/write (żądania Concurrent w puli wątków)
+        Epoll,      // nieblokujące gniazda, pętle zdarzeń epoll (Linux)
+        Uring,      // io_uring (Linux, wymaga budowania z WITH_URING)
+        Coroutine,  // korutyny w pętlach zdarzeń (EventLoop)
+    };
+
+    /*------- Config:
+    Ustawienia serwera podawane w linii poleceń.
+    -------------------------------------------------------------------*/
+    struct Config final {
+        int port{123456};
+        size_t workers{};     // 0 - po jednym wątku na rdzeń.
+        Transport transport{Transport::Blocking};
+        String identity{};    // plik z kluczem serwera (pusty - domyślny)
+        bool signedOnly{};    // wymagaj sygnatur RSA dla każdego komunikatu
+        bool jsonOnly{};      // komunikaty jako JSON (do śledzenia), zamiast formatu binarnego
+        bool ordered{};       // żądania połączenia zawsze po kolei (bez Dispatch::Concurrent)
+        bool uncompressed{};  // bez kompresji komunikatów, nawet jeśli klient ją proponuje
+        size_t maxFrame{};    // największa ramka od klienta w bajtach (0 - domyślna)
+        bool relaxedSync{};   // PRAGMA synchronous=NORMAL zamiast FULL (szybciej, mniej trwale)
+        Level logLevel{Level::Info};  // Debug - także treść każdego żądania i odpowiedzi
+
+        /// Odczyt ustawień z argumentów programu.
+        /// Np.: Server --workers 8 --transport epoll|uring|coro|blocking --format json|beve --dispatch ordered|concurrent --compression none|zstd --max-frame 67108864 --sync full|normal --log error|warning|info|debug|trace|off
+        static Config fromArgs(int const argc, char* argv[]) noexcept {
+            Config config{};
+            for (int i = 1; i + 1 < argc; i += 2) {
+                std::string_view const key{argv[i]};
+                std::string_view const value{argv[i + 1]};
+
+                if (key == "--port")
+                    number(value, config.port);
+                else if (key == "--workers")
+                    number(value, config.workers);
+                else if (key == "--transport")
+                    config.transport = transport(value);
+                else if (key == "--identity")
+                    config.identity = value;
+                else if (key == "--auth")
+                    config.signedOnly = (value == "signed");
+                else if (key == "--format")
+                    config.jsonOnly = (value == "json");
+                else if (key == "--dispatch")
+                    config.ordered = (value == "ordered");
+                else if (key == "--compression")
+                    config.uncompressed = (value == "none");
+                else if (key == "--max-frame")
+                    number(value, config.maxFrame);
+                else if (key == "--sync")
+                    config.relaxedSync = (value == "normal");
+                else if (key == "--log") {
+                    if (auto const level = Logger::parse(value))
+                        config.logLevel = level.value();
+                }
+            }
+            return config;
+        }
+
+    private:
+        static Transport transport(std::string_view const name) noexcept {
+            if (name == "epoll")
+                return Transport::Epoll;
+            if (name == "uring")
+                return Transport::Uring;
+            if (name == "coro")
+                return Transport::Coroutine;
+            return Transport::Blocking;
+        }
+
+        template<typename T>
+        static void number(std::string_view const text, T& out) noexcept {
+            T value{};
+            if (auto const [_, ec] = std::from_chars(text.data(), text.data() + text.size(), value); ec == std::errc{})
+                out = value;
+        }
+    };
+}
@@ -0,0 +1,101 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "cursor.h"
+#include <sqlite3.h>
+
+namespace bee {
+
+    Result<std::unique_ptr<Cursor>,String> Cursor::open(Statements& statements, String const& sql) noexcept {
+        std::unique_ptr<Cursor> cursor{new (std::nothrow) Cursor{}};
+        if (not cursor)
+            return Failure(String{"Out of memory"});
+
+        auto stmt = statements.acquire(sql);
+        if (not stmt)
+            return Failure(stmt.error());
+        cursor->stmt_ = std::move(stmt.value());
+        if (not cursor->stmt_.get())
+            // Tekst bez polecenia (np. sam komentarz).
+            cursor->done_ = true;
+        return cursor;
+    }
+
+    Result<size_t,String> Cursor::fetch(size_t const max_rows, size_t const max_bytes, Vector<u8>& out) noexcept {
+        auto const stmt = stmt_.get();
+        auto const ncolumns = stmt ? sqlite3_column_count(stmt) : 0;
+        if (names_.size() != static_cast<size_t>(ncolumns)) {
+            names_.reserve(ncolumns);
+            for (int i = 0; i < ncolumns; ++i)
+                names_.emplace_back(sqlite3_column_name(stmt, i));
+        }
+
+        // Porcja trafia do out jeszcze przed powrotem - arena nie musi przetrwać tej funkcji.
+        ColumnsBuilder chunk{names_, Arena::local().resource()};
+        while (not done_ and chunk.rows() < max_rows and chunk.bytes() < max_bytes) {
+            auto const stat = sqlite3_step(stmt);
+            if (stat == SQLITE_DONE) {
+                done_ = true;
+                break;
+            }
+            if (stat != SQLITE_ROW)
+                return Failure(error());
+
+            chunk.row();
+            for (int i = 0; i < ncolumns; ++i) {
+                switch (sqlite3_column_type(stmt, i)) {
+                    case SQLITE_INTEGER:
+                        chunk.add(static_cast<i64>(sqlite3_column_int64(stmt, i)));
+                        break;
+                    case SQLITE_FLOAT:
+                        chunk.add(sqlite3_column_double(stmt, i));
+                        break;
+                    case SQLITE_TEXT: {
+                        auto const text = reinterpret_cast<char const*>(sqlite3_column_text(stmt, i));
+                        chunk.add(StringView{text, static_cast<size_t>(sqlite3_column_bytes(stmt, i))});
+                        break;
+                    }
+                    case SQLITE_BLOB: {
+                        auto const blob = static_cast<u8 const*>(sqlite3_column_blob(stmt, i));
+                        chunk.add(Span<const u8>{blob, static_cast<size_t>(sqlite3_column_bytes(stmt, i))});
+                        break;
+                    }
+                    default:
+                        chunk.add(nullptr);
+                }
+            }
+        }
+        auto const rows = chunk.rows();
+        chunk.encode(out);
+        return rows;
+    }
+
+    String Cursor::error() const noexcept {
+        return sqlite3_errmsg(stmt_.db());
+    }
+}
@@ -0,0 +1,74 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "../shared4cx/types.h"
+#include "../columns.h"
+#include "statements.h"
+#include "arena.h"
+
+namespace bee {
+
+    /*------- Cursor:
+    Wynik zapytania czytany wiersz po wierszu (sqlite3_step) i oddawany
+    porcjami - pamięć serwera nie zależy od liczby wierszy wyniku.
+    Polecenie jest wypożyczone z pamięci Statements wątku i wraca do niej
+    razem z zamknięciem kursora.
+    Porcja składana jest w arenie żądania (Arena::local) wątku, który
+    ją pobiera - kursor może przechodzić między wątkami.
+    -------------------------------------------------------------------*/
+    class Cursor final {
+        Statement stmt_{};
+        Vector<String> names_{};
+        bool done_{};
+    public:
+        /// Wykonanie zapytania.
+        /// \param statements Połączenie z bazą i pamięć skompilowanych poleceń.
+        /// \param sql Tekst zapytania.
+        /// \return Kursor lub opis błędu.
+        static Result<std::unique_ptr<Cursor>,String> open(Statements& statements, String const& sql) noexcept;
+
+        ~Cursor() = default;
+        Cursor(Cursor const&) = delete;
+        Cursor& operator=(Cursor const&) = delete;
+
+        /// Kolejna porcja wierszy.
+        /// \param max_rows Najwięcej wierszy w porcji.
+        /// \param max_bytes Przybliżony największy rozmiar porcji.
+        /// \param out Porcja zakodowana w układzie Columns.
+        /// \return Liczba wierszy w porcji lub opis błędu.
+        [[nodiscard]] Result<size_t,String> fetch(size_t max_rows, size_t max_bytes, Vector<u8>& out) noexcept;
+
+        /// Czy wszystkie wiersze zostały już pobrane.
+        [[nodiscard]] bool done() const noexcept { return done_; }
+
+    private:
+        Cursor() = default;
+        [[nodiscard]] String error() const noexcept;
+    };
+}
@@ -0,0 +1,160 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "executor.h"
+
+namespace bee {
+    thread_local Executor const* Executor::current_{};
+    thread_local size_t Executor::index_{};
+
+    Executor::Executor(size_t nworkers) {
+        if (nworkers == 0)
+            nworkers = std::max(1u, std::thread::hardware_concurrency());
+
+        queues_.reserve(nworkers);
+        for (size_t i = 0; i < nworkers; ++i)
+            queues_.push_back(std::make_unique<Queue>());
+
+        workers_.reserve(nworkers);
+        for (size_t i = 0; i < nworkers; ++i)
+            workers_.emplace_back([this, i](std::stop_token const& token) { loop(token, i); });
+    }
+
+    Executor::~Executor() {
+        shutdown();
+    }
+
+    bool Executor::submit(Job&& job) noexcept {
+        if (stopped_)
+            return {};
+
+        // Zadanie zlecone z wątku roboczego zostaje u niego (dane są jeszcze w jego cache),
+        // zadania z zewnątrz rozdzielamy po kolei pomiędzy kolejki.
+        auto const index = (current_ == this) ? index_ : next_++ % queues_.size();
+        {
+            auto& queue = *queues_[index];
+            std::lock_guard lock{queue.mutex};
+            queue.jobs.push_back(std::move(job));
+        }
+        {
+            std::lock_guard lock{mutex_};
+            ++pending_;
+        }
+        cv_.notify_one();
+        return true;
+    }
+
+    bool Executor::submit(size_t const worker, Job&& job) noexcept {
+        if (stopped_ or worker >= queues_.size())
+            return {};
+
+        auto& queue = *queues_[worker];
+        {
+            std::lock_guard lock{queue.mutex};
+            queue.pinned.push_back(std::move(job));
+        }
+        {
+            std::lock_guard lock{mutex_};
+            ++queue.waiting;
+        }
+        // Zadanie może wykonać tylko jeden wątek - budzimy wszystkie.
+        cv_.notify_all();
+        return true;
+    }
+
+    void Executor::shutdown() noexcept {
+        if (stopped_.exchange(true))
+            return;
+
+        for (auto& worker : workers_)
+            worker.request_stop();
+        cv_.notify_all();
+        for (auto& worker : workers_)
+            if (worker.joinable())
+                worker.join();
+    }
+
+    void Executor::loop(std::stop_token const& token, size_t const index) noexcept {
+        current_ = this;
+        index_ = index;
+        auto const& queue = *queues_[index];
+
+        while (true) {
+            auto job = pop(index);
+            if (not job)
+                job = steal(index);
+            if (job) {
+                (*job)();
+                continue;
+            }
+            // Nie ma nic do zrobienia, czekamy na nowe zadania.
+            // Po żądaniu zatrzymania wątek kończy pracę dopiero, gdy wszystkie kolejki są puste.
+            std::unique_lock lock{mutex_};
+            if (not cv_.wait(lock, token, [this, &queue] { return pending_ > 0 or queue.waiting > 0; }))
+                break;
+        }
+    }
+
+    /// Pobranie zadania z własnej kolejki (od początku, najstarsze - nowsze zadania
+    /// nie mogą wstrzymywać starszych). Najpierw zadania przypięte - to dalsze
+    /// części pracy już rozpoczętej.
+    Option<Executor::Job> Executor::pop(size_t const index) noexcept {
+        auto& queue = *queues_[index];
+        std::lock_guard lock{queue.mutex};
+        if (not queue.pinned.empty()) {
+            auto job = std::move(queue.pinned.front());
+            queue.pinned.pop_front();
+            --queue.waiting;
+            return job;
+        }
+        if (queue.jobs.empty())
+            return {};
+
+        auto job = std::move(queue.jobs.front());
+        queue.jobs.pop_front();
+        --pending_;
+        return job;
+    }
+
+    /// Podkradnięcie zadania z kolejki innego wątku (od początku, najstarsze).
+    Option<Executor::Job> Executor::steal(size_t const index) noexcept {
+        auto const n = queues_.size();
+        for (size_t i = 1; i < n; ++i) {
+            auto& queue = *queues_[(index + i) % n];
+            std::unique_lock lock{queue.mutex, std::try_to_lock};
+            if (not lock or queue.jobs.empty())
+                continue;
+
+            auto job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+            --pending_;
+            return job;
+        }
+        return {};
+    }
+}
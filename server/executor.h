@@ -0,0 +1,110 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "../shared4cx/types.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace bee {
+
+    /*------- Executor:
+    Pula wątków z podkradaniem zadań (work-stealing).
+    Każdy wątek roboczy ma własną kolejkę. Zadania zlecone z wątku
+    roboczego trafiają do jego kolejki, pozostałe rozdzielane są po kolei.
+    Wątek, który nie ma nic do roboty, podkrada zadania z kolejek innych.
+    Zadania wykonywane są w kolejności zlecenia. Zadanie można też przypiąć
+    do wątku (np. dalszy ciąg pracy na jego połączeniu z bazą) - takiego
+    zadania inne wątki nie podkradają. Pula jest na zadania
+    krótkie - zadanie, które długo czeka (np. na dane z gniazda),
+    zajmuje jeden z niewielu wątków.
+    -------------------------------------------------------------------*/
+    class Executor final {
+    public:
+        using Job = std::move_only_function<void()>;
+
+        /// Utworzenie puli.
+        /// \param nworkers Liczba wątków roboczych (0 - po jednym na rdzeń).
+        explicit Executor(size_t nworkers = 0);
+        ~Executor();
+
+        Executor(Executor const&) = delete;
+        Executor& operator=(Executor const&) = delete;
+        Executor(Executor&&) = delete;
+        Executor& operator=(Executor&&) = delete;
+
+        /// Zlecenie zadania do wykonania.
+        /// \return false jeśli pula jest już zatrzymywana.
+        bool submit(Job&& job) noexcept;
+
+        /// Zlecenie zadania, które wykona tylko wskazany wątek roboczy.
+        /// \param worker Numer wątku (worker()).
+        /// \return false jeśli pula jest już zatrzymywana.
+        bool submit(size_t worker, Job&& job) noexcept;
+
+        /// Numer bieżącego wątku roboczego (nic - wywołanie spoza wątków tej puli).
+        [[nodiscard]] Option<size_t> worker() const noexcept {
+            if (current_ == this)
+                return index_;
+            return {};
+        }
+
+        /// Zatrzymanie puli. Zadania już zlecone są wykonywane do końca.
+        void shutdown() noexcept;
+
+        [[nodiscard]] size_t size() const noexcept { return workers_.size(); }
+
+    private:
+        struct Queue {
+            std::mutex mutex{};
+            std::deque<Job> jobs{};
+            std::deque<Job> pinned{};        // zadania tylko dla tego wątku
+            std::atomic<size_t> waiting{};   // liczba zadań w pinned
+        };
+
+        Vector<std::unique_ptr<Queue>> queues_{};
+        Vector<std::jthread> workers_{};
+        std::mutex mutex_{};
+        std::condition_variable_any cv_{};
+        std::atomic<size_t> pending_{};
+        std::atomic<size_t> next_{};
+        std::atomic_bool stopped_{};
+
+        static thread_local Executor const* current_;
+        static thread_local size_t index_;
+
+        void loop(std::stop_token const& token, size_t index) noexcept;
+        Option<Job> pop(size_t index) noexcept;
+        Option<Job> steal(size_t index) noexcept;
+    };
+}
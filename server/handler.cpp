@@ -27,11 +27,15 @@
 /*------- include files:
 -------------------------------------------------------------------*/
 #include "handler.h"
+#include "arena.h"
+#include "cursor.h"
+#include "statistics.h"
 #include "../shared4cx/shared.h"
-#include "../sqlite4cx/sqlite4cx.hpp"
 #include <ranges>
 #include <algorithm>
 #include <format>
+#include <limits>
+#include <mutex>
 
 namespace rg = std::ranges;
 namespace rv = std::ranges::views;
@@ -43,20 +47,94 @@ static constexpr auto RequestTypeNotSupported = "Request type is not supported";
 static constexpr auto RequestSubTypeNotSupported = "Request sub-type is not supported";
 static constexpr auto DatabaseOpened = "Database opened";
 static constexpr auto DatabaseCreated = "Database created";
+static constexpr auto NestedBatchNotSupported = "Nested batch is not supported";
+static constexpr auto DatabaseChangeInTransaction = "Database cannot be opened or created inside a transaction";
+static constexpr auto BatchFailed = "Some requests in batch failed";
+static constexpr auto TransactionRolledBack = "Transaction rolled back";
+static constexpr auto NoDatabase = "No database is open";
+static constexpr auto StatisticsCleared = "Statistics cleared";
+// Porcja wyniku Select: najwięcej wierszy i (w przybliżeniu) bajtów.
+static constexpr size_t ChunkRows = 1024;
+static constexpr size_t ChunkBytes = 256 * 1024;
+static constexpr auto ResultTooLarge = "Result does not fit in one message, send the Select outside a batch";
 
 namespace bee {
-    static Response handleDatabaseRequest(Request&& request);
-    static Response handleTableRequest(Request&& request);
+    static Response handleDatabaseRequest(Session& session, Request&& request);
+    static Response handleTableRequest(Session& session, Request&& request);
+    static Response handleBatchRequest(Session& session, Request&& request);
+    static Response handleQueryRequest(Session& session, Request&& request);
+    static Response handleStatsRequest(Request&& request);
+    static Result<std::unique_ptr<Cursor>,String> openCursor(Session const& session, String const& sql);
+    static Response openDatabase(Session& session, Request const& request, bool create);
+    static Option<String> control(char const* sql, std::shared_ptr<Pool> const& pool);
+    static Option<String> write(String const& sql, std::shared_ptr<Pool> const& pool);
 
-    Response handleRequest(Request &&request) {
+    /// Największy wynik w jednej odpowiedzi: mieści się w ramce (Socket::maxFrame),
+    /// z zapasem na resztę odpowiedzi, i w offsetach u32 układu Columns.
+    static size_t resultLimit() noexcept {
+        return std::min<size_t>(Socket::maxFrame() / 2, std::numeric_limits<u32>::max());
+    }
+
+    Response handleRequest(Session& session, Request&& request) {
         switch (request.type) {
             case Database:
-                return handleDatabaseRequest(std::move(request));
+                return handleDatabaseRequest(session, std::move(request));
             case Table:
-                return handleTableRequest(std::move(request));
+                return handleTableRequest(session, std::move(request));
+            case Batch:
+                return handleBatchRequest(session, std::move(request));
+            case ExecQuery:
+                return handleQueryRequest(session, std::move(request));
+            case Stats:
+                return handleStatsRequest(std::move(request));
             default:
-                return Response{.code = -1, .message = RequestTypeNotSupported};
+                return Response{.id = request.id, .code = -1, .message = RequestTypeNotSupported};
+        }
+    }
+
+    Reply handleRequestStream(Session& session, Request&& request) {
+        if (request.type != ExecQuery or request.subType != Select)
+            return Reply{handleRequest(session, std::move(request))};
+
+        auto cursor = openCursor(session, request.value);
+        if (not cursor)
+            return Reply{Response{.id = request.id, .code = -1, .message = cursor.error()}};
+        return Reply{request.id, std::move(cursor.value())};
+    }
+
+    /****************************************************************
+     *                                                              *
+     *                          R E P L Y                           *
+     *                                                              *
+     ****************************************************************/
+
+    Reply::Reply(Response&& response) noexcept : single_{std::move(response)} {}
+    Reply::Reply(size_t const id, std::unique_ptr<Cursor>&& cursor) noexcept : id_{id}, cursor_{std::move(cursor)} {}
+    Reply::~Reply() = default;
+    Reply::Reply(Reply&&) noexcept = default;
+    Reply& Reply::operator=(Reply&&) noexcept = default;
+
+    Option<Response> Reply::next() noexcept {
+        if (single_) {
+            auto response = std::move(single_);
+            single_.reset();
+            return response;
         }
+        if (not cursor_)
+            return {};
+
+        Response response{.id = id_};
+        if (auto const rows = cursor_->fetch(ChunkRows, ChunkBytes, response.data)) {
+            response.value = static_cast<int>(rows.value());
+            response.more = not cursor_->done();
+        }
+        else {
+            response.code = -1;
+            response.message = rows.error();
+        }
+        if (not response.more)
+            cursor_.reset();
+        return response;
     }
 
     /****************************************************************
@@ -65,43 +143,53 @@ namespace bee {
      *                                                              *
      ****************************************************************/
 
-    Response handleDatabaseRequest(Request&& request) {
+    Response handleDatabaseRequest(Session& session, Request&& request) {
         switch (request.subType) {
 
             //------- OPEN ------------------------------------------
-            case Open: {
-                auto const name = request.value;
-                if (auto home = homeDirectory()) {
-                    auto const path = std::format("{}/.beesoft_test", home.value());
-                    if (auto const err = createDirectory(path))
-                        return Response{.id = request.id, .code = err->code, .message = err->message};
+            case Open:
+                return openDatabase(session, request, false);
 
-                    Database::self().sqlite(std::format("{}/{}", path, name));
+            //------- CREATE ----------------------------------------
+            case Create:
+                return openDatabase(session, request, true);
 
-                    if (auto const stat = Database::self().open())
-                        return Response{.id = request.id, .code = stat->code, .message = stat->message};
+            default:
+                return Response{.id = request.id, .code = -1, .message = RequestSubTypeNotSupported};
+        }
+    }
 
-                    return Response{.id = request.id, .code = 0, .message = DatabaseOpened};
+    /// Wybór bazy dla sesji. Baza otwarta już przez inną sesję jest używana wspólnie.
+    Response openDatabase(Session& session, Request const& request, bool const create) {
+        if (auto home = homeDirectory()) {
+            auto const path = std::format("{}/.beesoft_test", home.value());
+            if (auto const err = createDirectory(path))
+                return Response{.id = request.id, .code = err->code, .message = err->message};
 
-                }
-                return Response{.id = request.id, .code = -1, .message = NoHomeDirectory};
-            }
+            auto ref = Registry::self().acquire(std::format("{}/{}", path, request.value), create);
+            if (not ref)
+                return Response{.id = request.id, .code = -1, .message = ref.error()};
+            session.database(std::move(ref.value()));
 
-            //------- CREATE ----------------------------------------
-            case Create: {
-                auto const name = request.value;
-                if (auto home = homeDirectory()) {
-                    auto const path = std::format("{}/.beesoft_test", home.value());
-                    if (auto const err = createDirectory(path))
-                        return Response{.id = request.id, .code = err->code, .message = err->message};
+            return Response{.id = request.id, .code = 0, .message = create ? DatabaseCreated : DatabaseOpened};
+        }
+        return Response{.id = request.id, .code = -1, .message = NoHomeDirectory};
+    }
 
-                    Database::self().sqlite(std::format("{}/{}", path, name));
-                    if (auto const stat = Database::self().create({}))
-                        return Response{.id = request.id, .code = stat->code, .message = stat->message};
+    /****************************************************************
+     *                                                              *
+     *                 T A B L E   H A N D L E R                    *
+     *                                                              *
+     ****************************************************************/
 
-                    return Response{.id = request.id, .code = 0, .message = DatabaseCreated};
+    Response handleTableRequest(Session& session, Request&& request) {
+        switch (request.subType) {
+            case Create: {
+                if (auto const& sql = request.value; not sql.empty()) {
+                    if (auto const err = write(sql, session.database()))
+                        return Response{.id = request.id, .code = -1, .message = err.value()};
                 }
-                return Response{.id = request.id, .code = -1, .message = NoHomeDirectory};
+                return Response{.id = request.id, .code = 0, .message = "Table created"};
             }
             default:
                 return Response{.id = request.id, .code = -1, .message = RequestSubTypeNotSupported};
@@ -110,21 +198,149 @@ namespace bee {
 
     /****************************************************************
      *                                                              *
-     *                 T A B L E   H A N D L E R                    *
+     *                 B A T C H   H A N D L E R                    *
+     *                                                              *
+     ****************************************************************/
+
+    Response handleBatchRequest(Session& session, Request&& request) {
+        // Transaction: jedna transakcja (jeden commit) dla wszystkich żądań,
+        // pierwszy błąd wycofuje całość i kończy obsługę.
+        // Żądania wykonywane są w tym wątku, więc w tym samym połączeniu co transakcja,
+        // blokada zapisu trzymana jest do końca transakcji.
+        auto const transaction = request.subType == Transaction;
+        auto const pool = session.database();
+        std::unique_lock<std::recursive_mutex> writing{};
+        if (transaction) {
+            if (not pool)
+                return Response{.id = request.id, .code = -1, .message = NoDatabase};
+            writing = pool->writer();
+            if (auto const err = control("BEGIN IMMEDIATE TRANSACTION", pool))
+                return Response{.id = request.id, .code = -1, .message = err.value()};
+        }
+
+        Response response{.id = request.id};
+        response.batch.reserve(request.batch.size());
+        int failed{};
+        size_t bytes{};
+        for (auto&& item : request.batch) {
+            // Zmiana bazy sesji w czasie transakcji przeniosłaby dalsze żądania poza nią.
+            auto answer = (item.type == Batch)
+                ? Response{.id = item.id, .code = -1, .message = NestedBatchNotSupported}
+                : (transaction and item.type == Database)
+                ? Response{.id = item.id, .code = -1, .message = DatabaseChangeInTransaction}
+                : handleRequest(session, std::move(item));
+            // Wyniki wszystkich żądań trafiają do jednej ramki.
+            bytes += answer.data.size();
+            if (bytes > resultLimit())
+                answer = Response{.id = answer.id, .code = -1, .message = ResultTooLarge};
+            if (answer.code != 0)
+                ++failed;
+            response.batch.push_back(std::move(answer));
+
+            if (failed and transaction) {
+                (void)control("ROLLBACK", pool);
+                response.code = -1;
+                response.message = TransactionRolledBack;
+                return response;
+            }
+        }
+
+        if (transaction) {
+            if (auto const err = control("COMMIT", pool)) {
+                (void)control("ROLLBACK", pool);
+                response.code = -1;
+                response.message = err.value();
+                return response;
+            }
+        }
+        if (failed) {
+            response.code = -1;
+            response.value = failed;
+            response.message = BatchFailed;
+        }
+        return response;
+    }
+
+    /****************************************************************
+     *                                                              *
+     *                 Q U E R Y   H A N D L E R                    *
      *                                                              *
      ****************************************************************/
 
-    Response handleTableRequest(Request&& request) {
+    Response handleQueryRequest(Session& session, Request&& request) {
         switch (request.subType) {
-            case Create: {
-                if (auto const name = request.value; not name.empty()) {
-                    auto const stat = Database::self().exec(name);
-                }
-                return Response{.id = request.id, .code = 0, .message = "Table created"};
+            //------- SELECT ----------------------------------------
+            // Cały wynik w jednej odpowiedzi (np. w Batch),
+            // transporty używają handleRequestStream.
+            // Wynik, który nie zmieści się w jednej ramce, jest odrzucany.
+            case Select: {
+                auto cursor = openCursor(session, request.value);
+                if (not cursor)
+                    return Response{.id = request.id, .code = -1, .message = cursor.error()};
+                Response response{.id = request.id};
+                auto const rows = cursor.value()->fetch(SIZE_MAX, resultLimit(), response.data);
+                if (not rows)
+                    return Response{.id = request.id, .code = -1, .message = rows.error()};
+                if (not cursor.value()->done())
+                    return Response{.id = request.id, .code = -1, .message = ResultTooLarge};
+                response.value = static_cast<int>(rows.value());
+                return response;
+            }
+            //------- INNE POLECENIA --------------------------------
+            default:
+                if (auto const err = write(request.value, session.database()))
+                    return Response{.id = request.id, .code = -1, .message = err.value()};
+                return Response{.id = request.id, .code = 0};
+        }
+    }
+
+    /****************************************************************
+     *                                                              *
+     *                 S T A T S   H A N D L E R                    *
+     *                                                              *
+     ****************************************************************/
+
+    /// Zestawienie czasów obsługi żądań (Statistics) w Response::data, w układzie Columns.
+    Response handleStatsRequest(Request&& request) {
+        switch (request.subType) {
+            case None: {
+                Response response{.id = request.id};
+                response.value = static_cast<int>(Statistics::self().encode(response.data, Arena::local().resource()));
+                return response;
             }
+            case Delete:
+                Statistics::self().reset();
+                return Response{.id = request.id, .code = 0, .message = StatisticsCleared};
             default:
                 return Response{.id = request.id, .code = -1, .message = RequestSubTypeNotSupported};
         }
     }
 
-}
\ No newline at end of file
+    Result<std::unique_ptr<Cursor>,String> openCursor(Session const& session, String const& sql) {
+        auto const pool = session.database();
+        if (not pool)
+            return Failure(String{NoDatabase});
+        auto const handle = pool->handle();
+        if (not handle)
+            return Failure(handle.error());
+        return Cursor::open(*handle.value(), sql);
+    }
+
+    /// Wykonanie polecenia w połączeniu wątku (sterowanie transakcją Batch).
+    Option<String> control(char const* const sql, std::shared_ptr<Pool> const& pool) {
+        if (not pool)
+            return String{NoDatabase};
+        auto const handle = pool->handle();
+        if (not handle)
+            return handle.error();
+        auto const writing = pool->writer();
+        return handle.value()->control(sql);
+    }
+
+    /// Zapis - we wspólnej transakcji z zapisami innych sesji (Pool::write).
+    Option<String> write(String const& sql, std::shared_ptr<Pool> const& pool) {
+        if (not pool)
+            return String{NoDatabase};
+        return pool->write(sql);
+    }
+}
@@ -29,7 +29,58 @@
 -------------------------------------------------------------------*/
 #include "../request.h"
 #include "../response.h"
+#include "registry.h"
+#include <memory>
+#include <mutex>
 
 namespace bee {
-    Response handleRequest(Request&& request);
+    class Cursor;
+
+    /*------- Session:
+    Stan połączenia klienta potrzebny przy obsłudze żądań - baza wybrana
+    przez Open/Create (inne połączenia mogą używać innych baz).
+    Żądania jednego połączenia mogą być wykonywane równolegle
+    (Dispatch::Concurrent), stąd blokada.
+    -------------------------------------------------------------------*/
+    class Session final {
+        mutable std::mutex mutex_{};
+        DatabaseRef database_{};
+    public:
+        /// Pula połączeń wybranej bazy (nic - baza nie została wybrana).
+        [[nodiscard]] std::shared_ptr<Pool> database() const noexcept {
+            std::lock_guard lock{mutex_};
+            return database_.pool();
+        }
+
+        /// Wybór bazy, poprzednia jest zwalniana (zostaje w rejestrze do czasu zamknięcia).
+        void database(DatabaseRef&& ref) noexcept {
+            DatabaseRef previous{};
+            std::lock_guard lock{mutex_};
+            previous = std::exchange(database_, std::move(ref));
+        }
+    };
+
+    /*------- Reply:
+    Odpowiedź na żądanie pobierana częściami. Zwykle jest jedna część,
+    wynik Select czytany jest kursorem i oddawany porcjami (Response::more).
+    -------------------------------------------------------------------*/
+    class Reply final {
+        Option<Response> single_{};
+        size_t id_{};
+        std::unique_ptr<Cursor> cursor_{};
+    public:
+        explicit Reply(Response&& response) noexcept;
+        Reply(size_t id, std::unique_ptr<Cursor>&& cursor) noexcept;
+        ~Reply();
+        Reply(Reply&&) noexcept;
+        Reply& operator=(Reply&&) noexcept;
+
+        /// Kolejna część odpowiedzi (nic - odpowiedź została już oddana w całości).
+        [[nodiscard]] Option<Response> next() noexcept;
+    };
+
+    /// Obsługa żądania, cała odpowiedź w jednym obiekcie.
+    Response handleRequest(Session& session, Request&& request);
+    /// Obsługa żądania z odpowiedzią oddawaną częściami (Select) - tego używają transporty.
+    Reply handleRequestStream(Session& session, Request&& request);
 }
@@ -0,0 +1,200 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "pool.h"
+#include <utility>
+
+/*------- local constants:
+-------------------------------------------------------------------*/
+static constexpr auto TransactionLeftOpen = "Write left a transaction open, rolled back";
+
+namespace bee {
+
+    Result<std::shared_ptr<Pool>,String> Pool::open(String path, bool const create) noexcept {
+        std::shared_ptr<Pool> pool{new (std::nothrow) Pool{std::move(path)}};
+        if (not pool)
+            return Failure(String{"Out of memory"});
+
+        // Tryb WAL zapisywany jest w pliku bazy, wystarczy ustawić go raz.
+        auto first = pool->connect(create);
+        if (not first)
+            return Failure(first.error());
+        if (auto const err = first.value()->exec("PRAGMA journal_mode=WAL"))
+            return Failure(err.value());
+
+        pool->handles_.emplace(std::this_thread::get_id(), std::move(first.value()));
+        pool->track();
+        return pool;
+    }
+
+    Result<std::shared_ptr<Statements>,String> Pool::handle() noexcept {
+        auto const id = std::this_thread::get_id();
+        {
+            std::lock_guard lock{mutex_};
+            if (auto const it = handles_.find(id); it != handles_.end())
+                return it->second;
+        }
+        // Otwieranie połączenia bez blokady - inne wątki nie muszą czekać.
+        auto handle = connect(false);
+        if (not handle)
+            return Failure(handle.error());
+        track();
+        std::lock_guard lock{mutex_};
+        return handles_.emplace(id, std::move(handle.value())).first->second;
+    }
+
+    void Pool::track() noexcept {
+        // Pule, w których wątek ma połączenie - przy końcu wątku są one zamykane.
+        struct Tracked {
+            Vector<std::weak_ptr<Pool>> pools{};
+            ~Tracked() {
+                auto const id = std::this_thread::get_id();
+                for (auto const& weak : pools)
+                    if (auto const pool = weak.lock())
+                        pool->release(id);
+            }
+        };
+        thread_local Tracked tracked{};
+        try {
+            std::erase_if(tracked.pools, [](auto const& pool) { return pool.expired(); });
+            tracked.pools.push_back(weak_from_this());
+        }
+        catch (...) {}
+    }
+
+    void Pool::release(std::thread::id const id) noexcept {
+        std::shared_ptr<Statements> handle{};
+        {
+            std::lock_guard lock{mutex_};
+            if (auto const it = handles_.find(id); it != handles_.end()) {
+                handle = std::move(it->second);
+                handles_.erase(it);
+            }
+        }
+        // Połączenie zamykane jest już bez blokady.
+    }
+
+    Option<String> Pool::write(String const& sql) noexcept {
+        auto const handle = this->handle();
+        if (not handle)
+            return handle.error();
+        if (handle.value()->transaction()) {
+            auto const writing = writer();
+            return handle.value()->exec(sql);
+        }
+
+        Pending pending{.sql = &sql, .error = {}, .done = false};
+        // Pętla zdarzeń nie może czekać na zebranie grupy ani na jej wykonanie przez inny wątek.
+        if (loop_) {
+            commit(*handle.value(), {&pending});
+            return std::move(pending.error);
+        }
+
+        // Pierwszy wątek, który zastanie pustą kolejkę, wykonuje całą grupę
+        // (także zapisy, które dołączą w czasie zbierania), pozostałe czekają na wynik.
+        std::unique_lock lock{group_mutex_};
+        queue_.push_back(&pending);
+        while (not pending.done) {
+            if (leading_) {
+                if (queue_.size() >= GroupSize)
+                    group_cv_.notify_all();
+                group_cv_.wait(lock, [&] { return pending.done or not leading_; });
+                continue;
+            }
+            leading_ = true;
+            // Samotny zapis nie czeka - grupa zbiera się w czasie jego wykonywania.
+            if (queue_.size() > 1)
+                group_cv_.wait_for(lock, GroupWindow, [this] { return queue_.size() >= GroupSize; });
+            auto const group = std::exchange(queue_, {});
+            lock.unlock();
+            commit(*handle.value(), group);
+            lock.lock();
+            for (auto const item : group)
+                item->done = true;
+            leading_ = false;
+            group_cv_.notify_all();
+        }
+        return std::move(pending.error);
+    }
+
+    /// Wykonanie grupy zapisów w jednej transakcji.
+    /// Polecenia klientów nie mogą sterować transakcją (Statements odrzuca je),
+    /// mimo to po zapisie połączenie musi wrócić do trybu autocommit.
+    void Pool::commit(Statements& handle, Vector<Pending*> const& group) noexcept {
+        auto const writing = writer();
+        commitGroup(handle, group);
+
+        if (handle.transaction()) {
+            (void)handle.control("ROLLBACK");
+            for (auto const item : group) {
+                if (not item->error)
+                    item->error = String{TransactionLeftOpen};
+            }
+        }
+    }
+
+    /// Każdy zapis (także samotny) ma swój SAVEPOINT - błąd, np. w drugim
+    /// z kilku poleceń, wycofuje cały ten zapis i tylko jego.
+    void Pool::commitGroup(Statements& handle, Vector<Pending*> const& group) noexcept {
+        if (auto const err = handle.control("BEGIN IMMEDIATE TRANSACTION")) {
+            for (auto const item : group)
+                item->error = err;
+            return;
+        }
+        for (auto const item : group) {
+            (void)handle.control("SAVEPOINT bee_write");
+            if (auto err = handle.exec(*item->sql)) {
+                item->error = std::move(err);
+                (void)handle.control("ROLLBACK TO bee_write");
+            }
+            (void)handle.control("RELEASE bee_write");
+        }
+        if (auto const err = handle.control("COMMIT")) {
+            (void)handle.control("ROLLBACK");
+            for (auto const item : group) {
+                if (not item->error)
+                    item->error = err;
+            }
+        }
+    }
+
+    size_t Pool::size() noexcept {
+        std::lock_guard lock{mutex_};
+        return handles_.size();
+    }
+
+    Result<std::shared_ptr<Statements>,String> Pool::connect(bool const create) const noexcept {
+        auto handle = Statements::open(path_, create);
+        if (not handle)
+            return Failure(handle.error());
+        // W trybie WAL NORMAL wystarcza do spójności bazy, ale nie do trwałości zapisów.
+        if (auto const err = handle.value()->exec(relaxed_ ? "PRAGMA synchronous=NORMAL" : "PRAGMA synchronous=FULL"))
+            return Failure(err.value());
+        return handle;
+    }
+}
@@ -0,0 +1,130 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "statements.h"
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace bee {
+
+    /*------- Pool:
+    Połączenia z jednym plikiem bazy, po jednym dla każdego wątku
+    (każde z własną pamięcią poleceń Statements).
+    Baza działa w trybie WAL - odczyty różnych wątków idą równolegle
+    i nie czekają na zapis. Zapisy przechodzą po kolei przez blokadę
+    writer(), zamiast rywalizować o blokadę pliku (SQLITE_BUSY).
+    Pojedyncze zapisy różnych wątków łączone są we wspólne transakcje
+    (write) - jedna synchronizacja pliku na całą grupę. Wątki pętli zdarzeń
+    nie czekają na grupę (obsługują wiele połączeń naraz).
+    Połączenie wątku zamykane jest, gdy wątek się kończy (wątki połączeń
+    klientów żyją tyle, co połączenie).
+    -------------------------------------------------------------------*/
+    class Pool final : public std::enable_shared_from_this<Pool> {
+        // Zapis czekający w grupie, wynik ustawia wątek, który ją wykonuje.
+        struct Pending {
+            String const* sql;
+            Option<String> error;
+            bool done;
+        };
+
+        String path_{};
+        static inline bool relaxed_{};
+        static inline thread_local bool loop_{};
+        std::mutex mutex_{};
+        std::unordered_map<std::thread::id, std::shared_ptr<Statements>> handles_{};
+        std::recursive_mutex write_{};
+
+        std::mutex group_mutex_{};
+        std::condition_variable group_cv_{};
+        Vector<Pending*> queue_{};
+        bool leading_{};
+
+        explicit Pool(String path) noexcept : path_{std::move(path)} {}
+    public:
+        /// Najwięcej zapisów w jednej grupie.
+        static constexpr size_t GroupSize = 64;
+        /// Jak długo zbierać grupę, gdy czeka w niej już więcej niż jeden zapis.
+        static constexpr std::chrono::microseconds GroupWindow{500};
+
+        Pool(Pool const&) = delete;
+        Pool& operator=(Pool const&) = delete;
+
+        /// Tryb synchronizacji pliku dla nowo otwieranych połączeń.
+        /// Domyślnie FULL - zatwierdzona transakcja przetrwa awarię zasilania.
+        /// NORMAL (relaxed) jest szybszy, ale ostatnie transakcje mogą
+        /// zostać utracone (baza pozostaje spójna).
+        static void relaxedSync(bool const enable) noexcept { relaxed_ = enable; }
+        [[nodiscard]] static bool relaxedSync() noexcept { return relaxed_; }
+
+        /// Oznaczenie bieżącego wątku jako wątku pętli zdarzeń (epoll, korutyny, io_uring).
+        /// Jego zapisy nie dołączają do grupy i nie czekają na inne - są zatwierdzane od razu.
+        static void eventLoopThread(bool const enable) noexcept { loop_ = enable; }
+
+        /// Otwarcie (lub utworzenie) bazy i przełączenie jej w tryb WAL.
+        /// \param path Plik bazy danych.
+        /// \param create Czy utworzyć plik, jeśli nie istnieje.
+        /// \return Pula połączeń lub opis błędu.
+        static Result<std::shared_ptr<Pool>,String> open(String path, bool create) noexcept;
+
+        /// Połączenie bieżącego wątku (otwierane przy pierwszym użyciu).
+        [[nodiscard]] Result<std::shared_ptr<Statements>,String> handle() noexcept;
+
+        /// Blokada zapisu - trzymana przez cały czas zmian w bazie (także całej transakcji).
+        /// Wątek, który ją ma, może ją brać ponownie (żądania wewnątrz Batch).
+        [[nodiscard]] std::unique_lock<std::recursive_mutex> writer() noexcept {
+            return std::unique_lock{write_};
+        }
+
+        /// Zapis (polecenie zmieniające bazę) wykonywany we wspólnej transakcji
+        /// z zapisami innych wątków. Błąd jednego zapisu nie wpływa na pozostałe
+        /// (każdy ma swój SAVEPOINT). Wewnątrz transakcji wątku (Batch)
+        /// polecenie wykonywane jest od razu, w wątku pętli zdarzeń (eventLoopThread)
+        /// zatwierdzane od razu we własnej transakcji. Polecenia sterujące transakcją
+        /// (BEGIN, COMMIT...) są odrzucane.
+        /// \return Opis błędu lub nic (zapis jest już zatwierdzony).
+        [[nodiscard]] Option<String> write(String const& sql) noexcept;
+
+        [[nodiscard]] String const& path() const noexcept { return path_; }
+        /// Liczba otwartych połączeń.
+        [[nodiscard]] size_t size() noexcept;
+
+    private:
+        Result<std::shared_ptr<Statements>,String> connect(bool create) const noexcept;
+        /// Zamknięcie połączenia bieżącego wątku razem z jego końcem.
+        void track() noexcept;
+        /// Usunięcie połączenia wątku, który się zakończył.
+        void release(std::thread::id id) noexcept;
+        void commit(Statements& handle, Vector<Pending*> const& group) noexcept;
+        void commitGroup(Statements& handle, Vector<Pending*> const& group) noexcept;
+    };
+}
@@ -0,0 +1,146 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "registry.h"
+#include <filesystem>
+#include <system_error>
+#include <utility>
+
+namespace bee {
+
+    /****************************************************************
+     *                                                              *
+     *                   D A T A B A S E   R E F                    *
+     *                                                              *
+     ****************************************************************/
+
+    DatabaseRef::DatabaseRef(String path, std::shared_ptr<Pool> pool) noexcept
+        : path_{std::move(path)}, pool_{std::move(pool)} {}
+
+    DatabaseRef::~DatabaseRef() {
+        release();
+    }
+
+    DatabaseRef::DatabaseRef(DatabaseRef&& other) noexcept
+        : path_{std::move(other.path_)}, pool_{std::move(other.pool_)} {}
+
+    DatabaseRef& DatabaseRef::operator=(DatabaseRef&& other) noexcept {
+        if (this != &other) {
+            release();
+            path_ = std::move(other.path_);
+            pool_ = std::move(other.pool_);
+        }
+        return *this;
+    }
+
+    void DatabaseRef::release() noexcept {
+        if (pool_) {
+            pool_.reset();
+            Registry::self().release(path_);
+        }
+    }
+
+    /****************************************************************
+     *                                                              *
+     *                       R E G I S T R Y                        *
+     *                                                              *
+     ****************************************************************/
+
+    /// Klucz bazy w rejestrze. Ten sam plik podany różnie (ścieżką względną,
+    /// przez "..", dowiązanie) musi trafić do jednej puli - inaczej miałby
+    /// dwie niezależne blokady zapisu. Plik nie musi jeszcze istnieć (Create).
+    static String canonical(String const& path) noexcept {
+        std::error_code ec{};
+        auto const result = std::filesystem::weakly_canonical(path, ec);
+        return ec ? path : result.string();
+    }
+
+    Result<DatabaseRef,String> Registry::acquire(String const& name, bool const create) noexcept {
+        auto const path = canonical(name);
+        {
+            std::lock_guard lock{mutex_};
+            if (auto const it = entries_.find(path); it != entries_.end()) {
+                ++it->second.refs;
+                return DatabaseRef{path, it->second.pool};
+            }
+        }
+
+        // Otwieranie bazy bez blokady - inne sesje nie muszą czekać.
+        auto pool = Pool::open(path, create);
+        if (not pool)
+            return Failure(pool.error());
+
+        std::lock_guard lock{mutex_};
+        if (not worker_.joinable())
+            worker_ = std::jthread{[this](std::stop_token const& token) { loop(token); }};
+        // Ta sama baza mogła zostać otwarta w międzyczasie przez inną sesję.
+        auto const [it, _] = entries_.try_emplace(path, Entry{std::move(pool.value()), 0, {}});
+        ++it->second.refs;
+        return DatabaseRef{path, it->second.pool};
+    }
+
+    void Registry::idle(std::chrono::seconds const timeout) noexcept {
+        std::lock_guard lock{mutex_};
+        idle_ = timeout;
+    }
+
+    size_t Registry::size() noexcept {
+        std::lock_guard lock{mutex_};
+        return entries_.size();
+    }
+
+    void Registry::release(String const& path) noexcept {
+        std::lock_guard lock{mutex_};
+        if (auto const it = entries_.find(path); it != entries_.end() and it->second.refs > 0) {
+            if (--it->second.refs == 0)
+                it->second.released = Clock::now();
+        }
+    }
+
+    /// Zamykanie baz bez odwołań (co najmniej raz na idle_).
+    void Registry::loop(std::stop_token const& token) {
+        std::unique_lock lock{mutex_};
+        while (not token.stop_requested()) {
+            auto const now = Clock::now();
+            Vector<std::shared_ptr<Pool>> closing{};
+            for (auto it = entries_.begin(); it != entries_.end();) {
+                if (it->second.refs == 0 and now - it->second.released >= idle_) {
+                    closing.push_back(std::move(it->second.pool));
+                    it = entries_.erase(it);
+                }
+                else
+                    ++it;
+            }
+            // Zamykanie połączeń poza blokadą.
+            lock.unlock();
+            closing.clear();
+            lock.lock();
+            cv_.wait_for(lock, token, std::chrono::seconds{std::max<long long>(idle_.count() / 2, 1)}, [] { return false; });
+        }
+    }
+}
@@ -0,0 +1,112 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "pool.h"
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace bee {
+    class Registry;
+
+    /*------- DatabaseRef:
+    Odwołanie sesji do bazy z rejestru. Dopóki istnieje,
+    baza (pula połączeń) pozostaje otwarta.
+    -------------------------------------------------------------------*/
+    class DatabaseRef final {
+        String path_{};
+        std::shared_ptr<Pool> pool_{};
+    public:
+        DatabaseRef() = default;
+        DatabaseRef(String path, std::shared_ptr<Pool> pool) noexcept;
+        ~DatabaseRef();
+        DatabaseRef(DatabaseRef&& other) noexcept;
+        DatabaseRef& operator=(DatabaseRef&& other) noexcept;
+        DatabaseRef(DatabaseRef const&) = delete;
+        DatabaseRef& operator=(DatabaseRef const&) = delete;
+
+        [[nodiscard]] std::shared_ptr<Pool> const& pool() const noexcept { return pool_; }
+    private:
+        void release() noexcept;
+    };
+
+    /*------- Registry:
+    Bazy otwarte przez wszystkie sesje, kluczem jest ścieżka pliku.
+    Ponowne otwarcie bazy, która jest w rejestrze, niczego nie kosztuje
+    (połączenia wątków i ich pamięć stron zostają). Baza, do której nie ma
+    odwołań dłużej niż idle(), jest zamykana przez wątek w tle.
+    -------------------------------------------------------------------*/
+    class Registry final {
+        using Clock = std::chrono::steady_clock;
+        struct Entry {
+            std::shared_ptr<Pool> pool;
+            size_t refs;
+            Clock::time_point released;
+        };
+
+        std::mutex mutex_{};
+        std::condition_variable_any cv_{};
+        std::unordered_map<String, Entry> entries_{};
+        std::chrono::seconds idle_{60};
+        std::jthread worker_{};
+
+        Registry() = default;
+    public:
+        Registry(Registry const&) = delete;
+        Registry& operator=(Registry const&) = delete;
+        Registry(Registry&&) = delete;
+        Registry& operator=(Registry&&) = delete;
+        ~Registry() = default;
+
+        static Registry& self() noexcept {
+            static Registry registry{};
+            return registry;
+        }
+
+        /// Odwołanie do bazy (otwieranej, jeśli nie ma jej w rejestrze).
+        /// \param name Plik bazy danych (w rejestrze pod ścieżką kanoniczną).
+        /// \param create Czy utworzyć plik, jeśli nie istnieje.
+        /// \return Odwołanie lub opis błędu.
+        [[nodiscard]] Result<DatabaseRef,String> acquire(String const& name, bool create) noexcept;
+
+        /// Po jakim czasie bez odwołań baza jest zamykana.
+        void idle(std::chrono::seconds timeout) noexcept;
+
+        /// Liczba baz w rejestrze.
+        [[nodiscard]] size_t size() noexcept;
+
+    private:
+        void release(String const& path) noexcept;
+        void loop(std::stop_token const& token);
+        friend class DatabaseRef;
+    };
+}
@@ -0,0 +1,245 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "statements.h"
+#include <algorithm>
+#include <cctype>
+#include <utility>
+#include <sqlite3.h>
+
+namespace bee {
+    // Jak długo czekać na blokadę trzymaną przez połączenie innego wątku.
+    static constexpr int BusyTimeout = 5000;
+    static constexpr auto TransactionControlDenied = "Transaction control statements are not allowed";
+
+    /// Czy za którymś średnikiem (poza literałami i komentarzami) jest jeszcze
+    /// coś do wykonania, czyli czy tekst ma kilka poleceń. Średniki w treści
+    /// wyzwalacza (BEGIN ...; END) też dają true - to tylko kosztuje pominięcie
+    /// pamięci poleceń, sqlite3_exec wykona taki tekst poprawnie.
+    static bool compound(StringView const sql) noexcept {
+        auto const n = sql.size();
+        for (size_t i = 0; i < n; ++i) {
+            switch (auto const c = sql[i]) {
+                case '\'':
+                case '"':
+                case '`':
+                case '[': {
+                    auto const close = (c == '[') ? ']' : c;
+                    // Podwojony znak zamykający ('') kończy literał i od razu otwiera następny.
+                    for (++i; i < n and sql[i] != close; ++i) {}
+                    break;
+                }
+                case '-':
+                    if (i + 1 < n and sql[i + 1] == '-')
+                        for (i += 2; i < n and sql[i] != '\n'; ++i) {}
+                    break;
+                case '/':
+                    if (i + 1 < n and sql[i + 1] == '*') {
+                        auto const end = sql.find("*/", i + 2);
+                        i = (end == StringView::npos) ? n : end + 1;
+                    }
+                    break;
+                case ';':
+                    return not std::ranges::all_of(sql.substr(i + 1), [](unsigned char const ch) {
+                        return std::isspace(ch) or ch == ';';
+                    });
+                default:
+                    break;
+            }
+        }
+        return false;
+    }
+
+    /****************************************************************
+     *                                                              *
+     *                      S T A T E M E N T                       *
+     *                                                              *
+     ****************************************************************/
+
+    Statement::Statement(std::shared_ptr<Statements> owner, String sql, sqlite3_stmt* const stmt, bool const whole) noexcept
+        : owner_{std::move(owner)}, sql_{std::move(sql)}, stmt_{stmt}, whole_{whole} {}
+
+    Statement::~Statement() {
+        release();
+    }
+
+    Statement::Statement(Statement&& other) noexcept
+        : owner_{std::move(other.owner_)}, sql_{std::move(other.sql_)}, stmt_{std::exchange(other.stmt_, nullptr)}, whole_{other.whole_} {}
+
+    Statement& Statement::operator=(Statement&& other) noexcept {
+        if (this != &other) {
+            release();
+            owner_ = std::move(other.owner_);
+            sql_ = std::move(other.sql_);
+            stmt_ = std::exchange(other.stmt_, nullptr);
+            whole_ = other.whole_;
+        }
+        return *this;
+    }
+
+    sqlite3* Statement::db() const noexcept {
+        return owner_ ? owner_->db() : nullptr;
+    }
+
+    void Statement::release() noexcept {
+        if (auto const stmt = std::exchange(stmt_, nullptr)) {
+            if (whole_ and owner_)
+                owner_->release(std::move(sql_), stmt);
+            else
+                sqlite3_finalize(stmt);
+        }
+        owner_.reset();
+    }
+
+    /****************************************************************
+     *                                                              *
+     *                     S T A T E M E N T S                      *
+     *                                                              *
+     ****************************************************************/
+
+    Result<std::shared_ptr<Statements>,String> Statements::open(String const& path, bool const create, size_t const capacity) noexcept {
+        std::shared_ptr<Statements> statements{new (std::nothrow) Statements{}};
+        if (not statements)
+            return Failure(String{"Out of memory"});
+
+        statements->path_ = path;
+        statements->capacity_ = std::max<size_t>(capacity, 1);
+        auto const flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX | (create ? SQLITE_OPEN_CREATE : 0);
+        if (sqlite3_open_v2(path.c_str(), &statements->db_, flags, nullptr) != SQLITE_OK)
+            return Failure(statements->error());
+        sqlite3_busy_timeout(statements->db_, BusyTimeout);
+        sqlite3_set_authorizer(statements->db_, authorize, statements.get());
+        return statements;
+    }
+
+    Statements::~Statements() {
+        for (auto const& entry : lru_)
+            sqlite3_finalize(entry.stmt);
+        sqlite3_close_v2(db_);
+    }
+
+    Result<Statement,String> Statements::acquire(String const& sql) noexcept {
+        if (auto const it = index_.find(sql); it != index_.end()) {
+            auto entry = std::move(*it->second);
+            lru_.erase(it->second);
+            index_.erase(it);
+            return Statement{shared_from_this(), std::move(entry.sql), entry.stmt, true};
+        }
+
+        sqlite3_stmt* stmt{};
+        char const* tail{};
+        if (sqlite3_prepare_v3(db_, sql.c_str(), static_cast<int>(sql.size()), SQLITE_PREPARE_PERSISTENT, &stmt, &tail) != SQLITE_OK)
+            return Failure(failure());
+
+        // Tekst z kilkoma poleceniami nie trafia do pamięci (zwolnienie je usuwa).
+        auto const rest = StringView{tail, sql.data() + sql.size()};
+        auto const whole = std::ranges::all_of(rest, [](unsigned char const c) { return std::isspace(c) or c == ';'; });
+        return Statement{shared_from_this(), whole ? sql : String{}, stmt, whole};
+    }
+
+    Option<String> Statements::exec(String const& sql) noexcept {
+        // Kilka poleceń od razu idzie do sqlite3_exec - bez kompilowania pierwszego
+        // z nich tylko po to, żeby się o tym przekonać. Taki tekst nie trafia do pamięci.
+        if (not index_.contains(sql) and compound(sql)) {
+            if (sqlite3_exec(db_, sql.c_str(), nullptr, nullptr, nullptr) != SQLITE_OK)
+                return failure();
+            return {};
+        }
+
+        auto statement = acquire(sql);
+        if (not statement)
+            return statement.error();
+
+        auto const stmt = statement->get();
+        if (not statement->whole()) {
+            if (sqlite3_exec(db_, sql.c_str(), nullptr, nullptr, nullptr) != SQLITE_OK)
+                return failure();
+            return {};
+        }
+        if (stmt) {
+            int stat{};
+            while ((stat = sqlite3_step(stmt)) == SQLITE_ROW) {}
+            if (stat != SQLITE_DONE)
+                return error();
+        }
+        return {};
+    }
+
+    /// Polecenia serwera nie trafiają do pamięci - skompilowane z pozwoleniem
+    /// nie mogą zostać potem wypożyczone dla polecenia klienta o tym samym tekście.
+    Option<String> Statements::control(char const* const sql) noexcept {
+        control_ = true;
+        auto const stat = sqlite3_exec(db_, sql, nullptr, nullptr, nullptr);
+        control_ = false;
+        if (stat != SQLITE_OK)
+            return error();
+        return {};
+    }
+
+    /// Wywoływana przez SQLite przy kompilacji każdego polecenia.
+    int Statements::authorize(void* const self, int const action, char const*, char const*, char const*, char const*) noexcept {
+        auto const statements = static_cast<Statements*>(self);
+        if ((action == SQLITE_TRANSACTION or action == SQLITE_SAVEPOINT) and not statements->control_) {
+            statements->denied_ = true;
+            return SQLITE_DENY;
+        }
+        return SQLITE_OK;
+    }
+
+    /// Opis błędu kompilacji lub wykonania polecenia klienta.
+    String Statements::failure() noexcept {
+        if (std::exchange(denied_, false))
+            return TransactionControlDenied;
+        return error();
+    }
+
+    void Statements::release(String&& sql, sqlite3_stmt* const stmt) noexcept {
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+        if (index_.contains(sql)) {
+            // To samo polecenie było wypożyczone dwa razy, zostaje jedna kopia.
+            sqlite3_finalize(stmt);
+            return;
+        }
+        lru_.push_front(Entry{std::move(sql), stmt});
+        index_.emplace(lru_.front().sql, lru_.begin());
+        if (lru_.size() > capacity_) {
+            index_.erase(lru_.back().sql);
+            sqlite3_finalize(lru_.back().stmt);
+            lru_.pop_back();
+        }
+    }
+
+    bool Statements::transaction() const noexcept {
+        return sqlite3_get_autocommit(db_) == 0;
+    }
+
+    String Statements::error() const noexcept {
+        return db_ ? sqlite3_errmsg(db_) : "Failed to open database";
+    }
+}
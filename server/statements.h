@@ -0,0 +1,127 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "../shared4cx/types.h"
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+namespace bee {
+    class Statements;
+
+    /*------- Statement:
+    Skompilowane polecenie wypożyczone z pamięci Statements.
+    Po zwolnieniu (destruktor) wraca do pamięci z wyzerowanym stanem
+    (sqlite3_reset, sqlite3_clear_bindings), gotowe dla następnego żądania.
+    -------------------------------------------------------------------*/
+    class Statement final {
+        std::shared_ptr<Statements> owner_{};
+        String sql_{};
+        sqlite3_stmt* stmt_{};
+        bool whole_{};
+    public:
+        Statement() = default;
+        Statement(std::shared_ptr<Statements> owner, String sql, sqlite3_stmt* stmt, bool whole) noexcept;
+        ~Statement();
+        Statement(Statement&& other) noexcept;
+        Statement& operator=(Statement&& other) noexcept;
+
+        [[nodiscard]] sqlite3_stmt* get() const noexcept { return stmt_; }
+        [[nodiscard]] sqlite3* db() const noexcept;
+        /// Czy polecenie obejmuje cały tekst SQL (za nim nie ma kolejnych poleceń).
+        [[nodiscard]] bool whole() const noexcept { return whole_; }
+    private:
+        void release() noexcept;
+    };
+
+    /*------- Statements:
+    Połączenie z bazą i pamięć LRU skompilowanych poleceń (kluczem jest
+    tekst SQL). Powtarzane polecenia nie są kompilowane od nowa.
+    Obiekt należy do jednego wątku (połączenie otwarte z SQLITE_OPEN_NOMUTEX).
+    Polecenia sterujące transakcją (BEGIN, COMMIT, ROLLBACK, SAVEPOINT, RELEASE)
+    odrzucane są już przy kompilacji - transakcjami steruje tylko serwer (control).
+    -------------------------------------------------------------------*/
+    class Statements final : public std::enable_shared_from_this<Statements> {
+        struct Entry {
+            String sql;
+            sqlite3_stmt* stmt;
+        };
+        sqlite3* db_{};
+        String path_{};
+        size_t capacity_{};
+        bool control_{};    // trwa polecenie control()
+        bool denied_{};     // kompilacja odrzucona przez authorize()
+        std::list<Entry> lru_{};    // na początku ostatnio używane
+        std::unordered_map<StringView, std::list<Entry>::iterator> index_{};
+    public:
+        static constexpr size_t DefaultCapacity = 64;
+
+        /// Otwarcie połączenia z bazą.
+        /// \param path Plik bazy danych.
+        /// \param create Czy utworzyć plik, jeśli nie istnieje.
+        /// \param capacity Najwięcej poleceń w pamięci.
+        /// \return Obiekt lub opis błędu.
+        static Result<std::shared_ptr<Statements>,String> open(String const& path, bool create = false, size_t capacity = DefaultCapacity) noexcept;
+
+        ~Statements();
+        Statements(Statements const&) = delete;
+        Statements& operator=(Statements const&) = delete;
+
+        /// Wypożyczenie skompilowanego polecenia (z pamięci lub nowo skompilowanego).
+        /// \param sql Tekst polecenia.
+        /// \return Polecenie lub opis błędu.
+        [[nodiscard]] Result<Statement,String> acquire(String const& sql) noexcept;
+
+        /// Wykonanie polecenia, które nie zwraca wierszy.
+        /// \return Opis błędu lub nic.
+        [[nodiscard]] Option<String> exec(String const& sql) noexcept;
+
+        /// Wykonanie polecenia sterującego transakcją (z pominięciem pamięci poleceń).
+        /// \param sql Polecenie, np. "BEGIN IMMEDIATE TRANSACTION".
+        /// \return Opis błędu lub nic.
+        [[nodiscard]] Option<String> control(char const* sql) noexcept;
+
+        [[nodiscard]] String const& path() const noexcept { return path_; }
+        [[nodiscard]] sqlite3* db() const noexcept { return db_; }
+        [[nodiscard]] size_t size() const noexcept { return lru_.size(); }
+        /// Czy połączenie jest w trakcie transakcji (BEGIN bez COMMIT/ROLLBACK).
+        [[nodiscard]] bool transaction() const noexcept;
+        [[nodiscard]] String error() const noexcept;
+
+    private:
+        Statements() = default;
+        void release(String&& sql, sqlite3_stmt* stmt) noexcept;
+        String failure() noexcept;
+        static int authorize(void* self, int action, char const*, char const*, char const*, char const*) noexcept;
+        friend class Statement;
+    };
+}
@@ -0,0 +1,193 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "statistics.h"
+#include "../columns.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <utility>
+
+namespace bee {
+
+    /****************************************************************
+     *                                                              *
+     *                      H I S T O G R A M                       *
+     *                                                              *
+     ****************************************************************/
+
+    void Histogram::record(u64 const value) noexcept {
+        buckets_[index(value)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+        auto max = max_.load(std::memory_order_relaxed);
+        while (value > max and not max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {}
+    }
+
+    void Histogram::reset() noexcept {
+        for (auto& bucket : buckets_)
+            bucket.store(0, std::memory_order_relaxed);
+        count_.store(0, std::memory_order_relaxed);
+        sum_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+    u64 Histogram::percentile(double const percent) const noexcept {
+        // Suma przedziałów - licznik count_ mógł się już zmienić.
+        u64 total{};
+        for (auto const& bucket : buckets_)
+            total += bucket.load(std::memory_order_relaxed);
+        if (total == 0)
+            return 0;
+
+        auto const wanted = std::clamp(static_cast<u64>(std::ceil(percent / 100.0 * static_cast<double>(total))), u64{1}, total);
+        u64 seen{};
+        for (size_t i = 0; i < Size; ++i) {
+            seen += buckets_[i].load(std::memory_order_relaxed);
+            if (seen >= wanted)
+                // Największa wartość przedziału, ale nie więcej niż największy pomiar.
+                return std::min(i + 1 < Size ? lowest(i + 1) - 1 : max(), max());
+        }
+        return max();
+    }
+
+    size_t Histogram::index(u64 value) noexcept {
+        value = std::min(value, (u64{1} << MaxBits) - 1);
+        if (value < SubCount)
+            return value;
+        // Przedział [2^k, 2^(k+1)) ma SubCount części po 2^(k - SubBits).
+        auto const k = static_cast<u32>(std::bit_width(value)) - 1;
+        return SubCount + (k - SubBits) * SubCount + ((value >> (k - SubBits)) - SubCount);
+    }
+
+    u64 Histogram::lowest(size_t const index) noexcept {
+        if (index < SubCount)
+            return index;
+        auto const k = (index - SubCount) / SubCount + SubBits;
+        auto const part = (index - SubCount) % SubCount;
+        return (SubCount + part) << (k - SubBits);
+    }
+
+    /****************************************************************
+     *                                                              *
+     *                     S T A T I S T I C S                      *
+     *                                                              *
+     ****************************************************************/
+
+    Statistics::~Statistics() {
+        for (auto& entry : entries_)
+            delete entry.load();
+    }
+
+    void Statistics::record(Sample const& sample) noexcept {
+        auto const entry = this->entry(sample.type, sample.subType);
+        if (not entry)
+            return;
+        entry->requests.fetch_add(1, std::memory_order_relaxed);
+        if (sample.failed)
+            entry->failed.fetch_add(1, std::memory_order_relaxed);
+        for (size_t i = 0; i < PhaseCount; ++i) {
+            if (sample.measured & (1u << i)) {
+                auto const ns = std::chrono::duration_cast<std::chrono::nanoseconds>(sample.phases[i]).count();
+                entry->phases[i].record(static_cast<u64>(std::max<i64>(ns, 0)));
+            }
+        }
+    }
+
+    size_t Statistics::encode(Vector<u8>& out, std::pmr::memory_resource* const resource) const {
+        static Vector<String> const names{"type", "subType", "requests", "failed", "phase", "count", "mean", "p50", "p90", "p99", "p999", "max"};
+        ColumnsBuilder builder{names, resource};
+        for (size_t n = 0; n < entries_.size(); ++n) {
+            auto const entry = entries_[n].load(std::memory_order_acquire);
+            if (not entry)
+                continue;
+            auto const type = str(static_cast<RequestType>(n / SubTypes));
+            auto const subType = str(static_cast<RequestSubType>(n % SubTypes));
+            auto const requests = entry->requests.load(std::memory_order_relaxed);
+            auto const failed = entry->failed.load(std::memory_order_relaxed);
+            auto first = true;
+            for (size_t i = 0; i < PhaseCount; ++i) {
+                auto const& histogram = entry->phases[i];
+                auto const count = histogram.count();
+                if (count == 0)
+                    continue;
+                builder.row();
+                builder.add(StringView{type});
+                builder.add(StringView{subType});
+                // Liczniki żądań dotyczą całej pary - tylko w jej pierwszym wierszu.
+                if (std::exchange(first, false)) {
+                    builder.add(static_cast<i64>(requests));
+                    builder.add(static_cast<i64>(failed));
+                }
+                else {
+                    builder.add(nullptr);
+                    builder.add(nullptr);
+                }
+                builder.add(StringView{str(static_cast<Phase>(i))});
+                builder.add(static_cast<i64>(count));
+                builder.add(static_cast<i64>(histogram.sum() / count));
+                for (auto const percent : {50.0, 90.0, 99.0, 99.9})
+                    builder.add(static_cast<i64>(histogram.percentile(percent)));
+                builder.add(static_cast<i64>(histogram.max()));
+            }
+        }
+        auto const rows = builder.rows();
+        builder.encode(out);
+        return rows;
+    }
+
+    void Statistics::reset() noexcept {
+        for (auto const& slot : entries_) {
+            if (auto const entry = slot.load(std::memory_order_acquire)) {
+                for (auto& histogram : entry->phases)
+                    histogram.reset();
+                entry->requests.store(0, std::memory_order_relaxed);
+                entry->failed.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    Statistics::Entry* Statistics::entry(RequestType const type, RequestSubType const subType) noexcept {
+        // Nieznane wartości (np. od nowszego klienta) liczone są jako Unknown/None.
+        auto const t = (type >= 0 and static_cast<size_t>(type) < Types) ? static_cast<size_t>(type) : size_t{Unknown};
+        auto const s = (subType >= 0 and static_cast<size_t>(subType) < SubTypes) ? static_cast<size_t>(subType) : size_t{None};
+        auto& slot = entries_[t * SubTypes + s];
+        if (auto const entry = slot.load(std::memory_order_acquire))
+            return entry;
+
+        auto const fresh = new (std::nothrow) Entry{};
+        if (not fresh)
+            return nullptr;
+        Entry* expected{};
+        if (slot.compare_exchange_strong(expected, fresh, std::memory_order_acq_rel))
+            return fresh;
+        // Inny wątek utworzył ją w międzyczasie.
+        delete fresh;
+        return expected;
+    }
+}
@@ -0,0 +1,172 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author: Piotr Pszczółkowski
+// Date: 18.10.2026
+// E-mail: piotr@beesoft.pl.
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "../shared4cx/types.h"
+#include "../request.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory_resource>
+
+namespace bee {
+
+    /// Etapy obsługi żądania, których czas jest mierzony.
+    enum class Phase : u8 {
+        Read,       // odczyt ramki z gniazda (od nadejścia jej nagłówka)
+        Decrypt,    // odszyfrowanie (i dekompresja)
+        Parse,      // odtworzenie Request
+        Handle,     // wykonanie żądania (razem z pobieraniem kolejnych części wyniku)
+        Serialize,  // serializacja Response
+        Encrypt,    // (kompresja i) zaszyfrowanie
+        Write,      // wysłanie ramek
+    };
+    static constexpr size_t PhaseCount = 7;
+
+    inline std::string str(Phase const phase) noexcept {
+        switch (phase) {
+            case Phase::Read: return "Read";
+            case Phase::Decrypt: return "Decrypt";
+            case Phase::Parse: return "Parse";
+            case Phase::Handle: return "Handle";
+            case Phase::Serialize: return "Serialize";
+            case Phase::Encrypt: return "Encrypt";
+            case Phase::Write: return "Write";
+        }
+        return "Unknown";
+    }
+
+    /*------- Histogram:
+    Rozkład czasów w nanosekundach, w stylu HDR: każdy przedział między
+    kolejnymi potęgami dwójki dzielony jest na 2^SubBits równych części,
+    więc błąd względny wartości nie przekracza 1/2^SubBits, a pamięć jest
+    stała. Zapis to kilka operacji atomowych, bez blokad.
+    -------------------------------------------------------------------*/
+    class Histogram final {
+    public:
+        static constexpr u32 SubBits = 5;
+        static constexpr u64 SubCount = u64{1} << SubBits;
+        /// Czasy dłuższe niż 2^MaxBits ns (~18 minut) liczone są jako najdłuższy.
+        static constexpr u32 MaxBits = 40;
+        static constexpr size_t Size = SubCount + (MaxBits - SubBits) * SubCount;
+
+        void record(u64 value) noexcept;
+        void reset() noexcept;
+
+        [[nodiscard]] u64 count() const noexcept { return count_.load(std::memory_order_relaxed); }
+        [[nodiscard]] u64 sum() const noexcept { return sum_.load(std::memory_order_relaxed); }
+        [[nodiscard]] u64 max() const noexcept { return max_.load(std::memory_order_relaxed); }
+        /// Wartość, której nie przekracza wskazany procent pomiarów (np. 99.9).
+        [[nodiscard]] u64 percentile(double percent) const noexcept;
+
+    private:
+        std::array<std::atomic<u64>, Size> buckets_{};
+        std::atomic<u64> count_{};
+        std::atomic<u64> sum_{};
+        std::atomic<u64> max_{};
+
+        static size_t index(u64 value) noexcept;
+        /// Najmniejsza wartość wskazanego przedziału.
+        static u64 lowest(size_t index) noexcept;
+    };
+
+    /*------- Sample:
+    Czasy etapów jednego żądania, zbierane w czasie jego obsługi
+    i zapisywane razem (Statistics::record) po wysłaniu odpowiedzi.
+    Etapy, których transport nie mierzy, nie są zapisywane.
+    -------------------------------------------------------------------*/
+    struct Sample final {
+        using Clock = std::chrono::steady_clock;
+
+        RequestType type{Unknown};
+        RequestSubType subType{None};
+        std::array<Clock::duration, PhaseCount> phases{};
+        u8 measured{};      // bity zmierzonych etapów
+        bool failed{};      // któraś część odpowiedzi miała code != 0
+
+        void add(Phase const phase, Clock::duration const time) noexcept {
+            auto const n = static_cast<size_t>(phase);
+            phases[n] += time;
+            measured |= static_cast<u8>(1u << n);
+        }
+
+        /// Wykonanie funkcji i dodanie czasu jej działania do wskazanego etapu.
+        template<typename F>
+        auto measure(Phase const phase, F&& f) {
+            auto const start = Clock::now();
+            auto result = std::forward<F>(f)();
+            add(phase, Clock::now() - start);
+            return result;
+        }
+    };
+
+    /*------- Statistics:
+    Histogramy czasów etapów i liczniki dla każdej pary RequestType/RequestSubType.
+    Histogramy pary tworzone są przy jej pierwszym żądaniu.
+    Zestawienie (żądanie Stats) ma układ Columns, wiersz na parę i etap:
+    type, subType (Text), requests, failed (Integer, tylko w pierwszym
+    wierszu pary, w pozostałych Null), phase (Text), count, mean, p50, p90,
+    p99, p999, max (Integer, czasy w nanosekundach).
+    -------------------------------------------------------------------*/
+    class Statistics final {
+        struct Entry {
+            std::array<Histogram, PhaseCount> phases{};
+            std::atomic<u64> requests{};
+            std::atomic<u64> failed{};
+        };
+        static constexpr size_t Types = Stats + 1;
+        static constexpr size_t SubTypes = Transaction + 1;
+
+        std::array<std::atomic<Entry*>, Types * SubTypes> entries_{};
+
+        Statistics() = default;
+    public:
+        Statistics(Statistics const&) = delete;
+        Statistics& operator=(Statistics const&) = delete;
+        Statistics(Statistics&&) = delete;
+        Statistics& operator=(Statistics&&) = delete;
+        ~Statistics();
+
+        static Statistics& self() noexcept {
+            static Statistics statistics{};
+            return statistics;
+        }
+
+        /// Zapisanie czasów obsłużonego żądania.
+        void record(Sample const& sample) noexcept;
+        /// Zestawienie w układzie Columns.
+        /// \param resource Pamięć tymczasowa składania zestawienia.
+        /// \return Liczba wierszy zestawienia.
+        size_t encode(Vector<u8>& out, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+        /// Wyzerowanie wszystkich histogramów i liczników.
+        void reset() noexcept;
+
+    private:
+        Entry* entry(RequestType type, RequestSubType subType) noexcept;
+    };
+}